@@ -13,13 +13,14 @@
  * Output: Edge matrix for graph T (Minimum weight spanning tree)
  * 
  * Compilation instructions: g++ -o graph_works.exe graph_works.cpp
+ *                           (add -O2 -fopenmp for the parallel modes)
  * Usage: ./graph_works.exe
  * 
  *==========================================================================*/
 
 /**============================================================================
  ** Implementation options and time complexity:
- **      adjacency matrix, searching	    O(|V|^2)
+ **      adjacency matrix, searching	    O(|V|^2)            <- in use
  **      binary heap and adjacency list	    O((|V| + |E|) log |V|) 
  **                                       = O(|E| log |V|)
  **      Fibonacci heap and adjacency list	O(|E| + |V| log |V|)
@@ -29,6 +30,13 @@
 #include <fstream>
 #include <vector>
 #include <limits>
+#include <queue>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <map>
+#include <string>
+#include <sys/stat.h>
 
 using namespace std;
 
@@ -62,24 +70,685 @@ struct MatrixInfo
     int maxEdgeCount;
 };
 
+// Heaviest-edge queries on paths of a spanning tree or forest
+class PathMaxTree
+{
+  private:
+    const vector< WeightedEdge > *edges; // Edge store the tree indexes into
+    vector< int > depth;                 // Depth of each vertex below its root
+    vector< int > component;             // Root of the tree holding each vertex
+    vector< vector< int > > up;          // up[k][x]: 2^k-th ancestor of x
+    vector< vector< int > > upMax;       // upMax[k][x]: heaviest edge on the
+                                         // jump from x to up[k][x], or -1
+    
+    int heavier( int a, int b ) const;
+    
+  public:
+    // Constructor (graph, vertex count, tree edge indices, locked edges)
+    // Locked edges are never reported as the maximum of a path
+    PathMaxTree( const vector< WeightedEdge > &G, unsigned int vertexCount,
+                 const vector< int > &treeEdges,
+                 const vector< char > &locked );
+    
+    // Index in G of the heaviest unlocked edge on the path a..b, or -1
+    int query( int a, int b ) const;
+};
+
+// Union-find over vertices (union by size, path halving)
+class DisjointSet
+{
+  private:
+    vector< int > parent;   // Parent of each element, roots are their own
+    vector< int > size;     // Element count below each root
+    
+  public:
+    // Constructor (element count)
+    DisjointSet( int count ) : parent( count ), size( count, 1 )
+        { for ( int i = 0; i < count; i++ ) parent[i] = i; };
+    
+    // Representative of the set holding x
+    int find( int x )
+        { while ( parent[x] != x ) x = parent[x] = parent[ parent[x] ];
+          return x; };
+    
+    // Merges the sets of a and b, false if they were already one set
+    bool join( int a, int b );
+};
+
+// Point cloud read from points.txt
+struct PointCloud
+{
+    int count;              // Number of points
+    int dimension;          // Coordinates per point
+    vector< double > coord; // count x dimension coordinates, row major
+};
+
+// Edge between two points of a point cloud
+struct GeometricEdge
+{
+    int u;                  // First unordered point
+    int v;                  // Second unordered point
+    double length;          // Euclidean distance between the points
+};
+
+// kd-tree over a point cloud, answering nearest neighbour queries
+class KdTree
+{
+  private:
+    const PointCloud *points;   // Points the tree indexes into
+    vector< int > order;        // Point indices, contiguous per node
+    vector< int > nodeBegin;    // First position in order of each node
+    vector< int > nodeEnd;      // One past the last position of each node
+    vector< int > nodeLeft;     // Left child of each node, -1 for leaves
+    vector< int > nodeRight;    // Right child of each node, -1 for leaves
+    vector< int > nodeLabel;    // Component shared by all points, or -1
+    vector< double > boxLo;     // Bounding box corners, dimension per node
+    vector< double > boxHi;
+    
+    int build( int begin, int end );
+    double box_distance( int node, int p ) const;
+    void search_foreign( int node, int p, const vector< int > &label,
+                         double &bestDist, int &best ) const;
+    void search_nearest( int node, int p, unsigned int k,
+                         vector< pair< double, int > > &heap ) const;
+    
+  public:
+    // Constructor (point cloud)
+    KdTree( const PointCloud &P );
+    
+    // Squared distance between points a and b
+    double distance( int a, int b ) const;
+    
+    // Records which nodes hold points of a single component
+    void label_nodes( const vector< int > &label );
+    
+    // Nearest point to p whose label differs from p's and whose squared
+    // distance is below bestDist; best is left alone if there is none
+    void nearest_foreign( int p, const vector< int > &label,
+                          double &bestDist, int &best ) const
+        { search_foreign( 0, p, label, bestDist, best ); };
+    
+    // The k nearest points to p other than p, nearest first
+    void nearest( int p, unsigned int k, vector< int > &result ) const;
+};
+
+// One merge of a single-linkage dendrogram. Clusters 0..n-1 are the
+// vertices, merge i creates cluster n+i.
+struct LinkageRow
+{
+    int first;              // Smaller cluster index merged
+    int second;             // Larger cluster index merged
+    int height;             // Weight of the tree edge causing the merge
+    int size;               // Vertex count of the new cluster
+};
+
+// 128-bit hash of a graph's canonical form
+struct GraphHash
+{
+    unsigned long long high;
+    unsigned long long low;
+    
+    bool operator<( const GraphHash &o ) const
+        { return ( high != o.high ) ? high < o.high : low < o.low; };
+};
+
+// State of the canonical labeling search
+struct CanonicalSearch
+{
+    const vector< vector< int > > *matrix;  // Graph being labeled
+    vector< unsigned long long > bestTrace; // Refinement traces on best path
+    vector< int > bestPath;                 // Vertices individualized on it
+    vector< int > bestLabel;                // Canonical position per vertex
+    vector< int > bestCode;                 // Relabeled matrix of best leaf
+    bool haveLeaf;                          // True once bestCode is valid
+    vector< vector< int > > automorphisms;  // Automorphisms found so far
+};
+
+// Adjacency matrix packed into 64-bit words, one row per vertex
+struct BitGraph
+{
+    int n;                                  // Vertex count
+    int words;                              // 64-bit words per row
+    vector< unsigned long long > bits;      // n rows of words
+    
+    const unsigned long long *row( int v ) const 
+        { return &bits[ (size_t)v * words ]; };
+};
+
+// Best clique shared by the parallel branches of the clique search
+struct CliqueSearch
+{
+    int best;                               // Size of the best clique
+    vector< int > clique;                   // Its vertices (BitGraph order)
+};
+
+// State of the DSATUR branch and bound coloring search
+struct ColoringSearch
+{
+    vector< vector< int > > adj;            // Neighbours of each vertex
+    vector< int > color;                    // Color of each vertex, or -1
+    vector< vector< int > > seen;           // seen[v][c]: neighbours of v
+                                            // with color c
+    vector< int > saturation;               // Distinct colors next to v
+    int best;                               // Colors of the best coloring
+    vector< int > bestColor;                // The best coloring
+    int lower;                              // Clique lower bound
+    long long nodes;                        // Search nodes visited
+    long long nodeLimit;                    // Visits allowed before giving up
+};
+
+// Union-find that can undo its unions (union by size, no path compression)
+class RollbackSet
+{
+  private:
+    vector< int > parent;                   // Parent of each element, or
+                                            // minus the size of its set
+    vector< pair< int, int > > history;     // (element, old parent) per write
+    
+  public:
+    // Constructor (element count)
+    RollbackSet( int count ) : parent( count, -1 ) {};
+    
+    // Representative of the set holding x
+    int find( int x ) const
+        { while ( parent[x] >= 0 ) x = parent[x]; return x; };
+    
+    // Number of writes so far, to roll back to later
+    int time() const { return history.size(); };
+    
+    // Merges the sets of a and b, false if they were already one set
+    bool join( int a, int b );
+    
+    // Undoes every write made after time t
+    void rollback( int t );
+};
+
+// Skew heap node of the arborescence engine, with a lazy weight offset
+struct ArcHeapNode
+{
+    int arc;                // Index in G of the arc
+    long long key;          // Reduced weight of the arc
+    long long delta;        // Offset still owed to this subtree
+    int left;               // Children, -1 if absent
+    int right;
+};
+
+// Edge list indexed by vertex pair, kept up to date by delta records.
+// Pairs are stored as create_graph stores them: u >= v.
+struct EdgeTable
+{
+    unsigned int vertexCount;           // Verticy cardinality
+    vector< WeightedEdge > G;           // Edges in no particular order
+    map< pair< int, int >, int > index; // Position in G of each (u, v)
+};
+
+// Outcome of applying one delta file
+struct DeltaCount
+{
+    int added;              // New edges
+    int removed;            // Deleted edges
+    int reweighted;         // Edges given a new weight
+    int skipped;            // Records that did not fit the graph
+};
+
+// Operation counts of a push-relabel run
+struct FlowCounters
+{
+    long long pushes;       // Pushes along an arc
+    long long relabels;     // Single vertex relabels
+    long long globals;      // Global relabels
+    long long gaps;         // Gap heuristic firings
+};
+
+// Residual network for maximum flow with Dinic's algorithm or push-relabel
+class FlowNetwork
+{
+  private:
+    vector< int > head;             // First arc out of each vertex, or -1
+    vector< int > next;             // Next arc out of the same tail
+    vector< int > to;               // Head of each arc; arc i^1 is its twin
+    vector< long long > capacity;   // Residual capacity of each arc
+    vector< long long > original;   // Capacity before any flow
+    vector< int > level;            // Distance from the source
+    vector< int > cursor;           // Next arc to try at each vertex
+    
+    bool build_levels( int s, int t );
+    long long push( int x, int t, long long limit );
+    void global_relabel( int s, int t, vector< int > &height ) const;
+    
+  public:
+    // Constructor (vertex count)
+    FlowNetwork( int vertexCount ) : head( vertexCount, -1 ) {};
+    
+    // Adds arcs a -> b and b -> a with the given capacities
+    void add_edge( int a, int b, long long forward, long long backward );
+    
+    // Removes all flow
+    void reset() { capacity = original; };
+    
+    // Value of a maximum flow from s to t (flow is kept until reset)
+    long long max_flow( int s, int t );
+    
+    // Value of a maximum flow from s to t by highest-label push-relabel.
+    // Only a maximum preflow is kept: use preflow_cut for the cut.
+    long long push_relabel( int s, int t, FlowCounters &counters );
+    
+    // Marks the vertices reachable from s in the residual network
+    void source_side( int s, vector< char > &side ) const;
+    
+    // Marks the vertices that cannot reach t in the residual network
+    void preflow_cut( int t, vector< char > &side ) const;
+};
+
+// State of the Edmonds blossom search for an augmenting path
+struct BlossomSearch
+{
+    vector< vector< int > > adj;            // Neighbours of each vertex
+    vector< int > match;                    // Partner of each vertex, or -1
+    vector< int > parent;                   // Previous vertex of the
+                                            // alternating tree, or -1
+    vector< int > base;                     // Base of the blossom holding
+                                            // each vertex
+    vector< char > used;                    // Marks outer vertices
+    vector< char > inBlossom;               // Marks bases on a new blossom
+    vector< int > queue;                    // Outer vertices to expand
+};
+
+// Distances between the cities of a tour: points of a point cloud, or
+// vertices of a complete weight matrix
+struct TourMetric
+{
+    const PointCloud *points;               // Cities as points, or NULL
+    const vector< vector< int > > *matrix;  // Cities as matrix rows
+    
+    // Distance between cities a and b
+    double distance( int a, int b ) const;
+};
+
+// Diameter bounds and the work spent on them
+struct DiameterBounds
+{
+    long long lower;        // Longest distance found so far
+    long long upper;        // No distance exceeds this
+    int from, to;           // Vertices at distance lower
+    long long searches;     // BFS or Dijkstra runs made
+};
+
+// Subproblem of the k-best spanning tree partition
+struct TreePartition
+{
+    vector< int > tree;     // Indices in G of the best tree in this subproblem
+    vector< char > state;   // Per edge of G: 0 free, 1 forced in, 2 forced out
+    int weight;             // Weight of tree
+    int swapOut;            // Tree edge removed by the cheapest exchange
+    int swapIn;             // Non-tree edge added by the cheapest exchange
+    int nextWeight;         // Weight of the tree after that exchange
+};
+
 /*=========================== function prototypes ===========================*/
 
 int launch_menu();
 
-bool valid_choice(char c);
+bool valid_choice(int c);
 
 void spanning_tree();
 
 void graph_generation();
 
-bool check_file ( ifstream &inputFile );
+bool check_file ( ifstream &inputFile, const char *fileName = "input.txt" );
 
 void print_graph( vector< WeightedEdge > G );
 
 void create_graph( ifstream &inputFile, vector< WeightedEdge > &G, 
                    unsigned int &vertexCount );
 
-int min_incident( vector< WeightedEdge > &G, vector< int > &vT );
+int min_incident( vector< WeightedEdge > &G, vector< vector< int > > &adj,
+                  vector< char > &inT, vector< int > &bestEdge );
+
+void join_tree( vector< WeightedEdge > &G, vector< vector< int > > &adj,
+                vector< char > &inT, vector< int > &bestEdge, int x );
+
+int prim_tree( vector< WeightedEdge > &G, unsigned int vertexCount,
+               vector< int > &treeEdges );
+
+bool load_graph( vector< WeightedEdge > &G, unsigned int &vertexCount );
+
+void build_adjacency( const vector< WeightedEdge > &G, 
+                      unsigned int vertexCount, vector< vector< int > > &adj );
+
+void boruvka_step( const vector< WeightedEdge > &G, unsigned int vertexCount,
+                   vector< int > &forest, vector< WeightedEdge > &H,
+                   vector< int > &origin, unsigned int &contractedCount );
+
+void kkt_forest( const vector< WeightedEdge > &G, unsigned int vertexCount,
+                 mt19937_64 &rng, vector< int > &forest );
+
+int kkt_tree( vector< WeightedEdge > &G, unsigned int vertexCount,
+              vector< int > &treeEdges );
+
+// Spanning tree variants
+void k_best_trees();
+
+bool best_trees( vector< WeightedEdge > &G, unsigned int vertexCount, int k,
+                 vector< TreePartition > &trees );
+
+bool best_swap( vector< WeightedEdge > &G, unsigned int vertexCount,
+                TreePartition &part );
+
+void euclidean_tree();
+
+bool read_points( PointCloud &P );
+
+double euclidean_mst( const PointCloud &P, vector< GeometricEdge > &T );
+
+void bottleneck_spanning_tree();
+
+bool bottleneck_tree( vector< WeightedEdge > &G, unsigned int vertexCount,
+                      vector< int > &treeEdges, int &bottleneck );
+
+void steiner();
+
+long long steiner_tree( vector< WeightedEdge > &G, unsigned int vertexCount,
+                        const vector< int > &terminals, 
+                        vector< int > &treeEdges );
+
+void degree_constrained_tree();
+
+long long capped_prim( const vector< WeightedEdge > &G, 
+                       const vector< vector< int > > &adj,
+                       const vector< int > &cap, mt19937_64 &rng, 
+                       double noise, vector< int > &treeEdges );
+
+long long repair_capped_tree( const vector< WeightedEdge > &G, 
+                              unsigned int vertexCount,
+                              const vector< int > &cap, 
+                              vector< int > &treeEdges );
+
+double capped_lower_bound( const vector< WeightedEdge > &G, 
+                           unsigned int vertexCount, 
+                           const vector< int > &cap, long long upperBound );
+
+// Approximate spanning tree weight
+void approximate_tree_weight();
+
+double component_share( const vector< WeightedEdge > &G, 
+                        const vector< vector< int > > &adj, int start,
+                        int threshold, int limit, vector< int > &mark,
+                        int stamp, vector< int > &queue, 
+                        long long &touched );
+
+// Spanning tree sensitivity
+void tree_sensitivity();
+
+void tree_tolerances( const vector< WeightedEdge > &G, 
+                      unsigned int vertexCount, 
+                      const vector< int > &treeEdges,
+                      vector< long long > &tolerance );
+
+int covered_top( vector< int > &jump, int x );
+
+// Graph deltas
+void graph_deltas();
+
+void index_edges( EdgeTable &table );
+
+void input_stamp( long long stamp[2] );
+
+bool read_graph_cache( EdgeTable &table );
+
+void write_graph_cache( const EdgeTable &table );
+
+bool apply_delta( EdgeTable &table, const string &fileName, 
+                  DeltaCount &count );
+
+void apply_edge_record( EdgeTable &table, char op, int a, int b, int w,
+                        DeltaCount &count );
+
+void write_matrix( const EdgeTable &table );
+
+// Global minimum cut
+void minimum_cut();
+
+long long stoer_wagner( const vector< WeightedEdge > &G, 
+                        unsigned int vertexCount, vector< char > &side );
+
+long long karger_stein( const vector< WeightedEdge > &G, 
+                        unsigned int vertexCount, int trials, 
+                        unsigned int seed, vector< char > &side );
+
+void contract_cut( const vector< WeightedEdge > &G, int vertexCount, 
+                   const vector< int > &label, mt19937_64 &rng, 
+                   long long &best, vector< char > &side );
+
+// Gomory-Hu trees
+void gomory_hu();
+
+void gomory_hu_tree( const vector< WeightedEdge > &G, 
+                     unsigned int vertexCount, vector< int > &parent,
+                     vector< long long > &weight );
+
+void tree_path_minimums( const vector< int > &parent, 
+                         const vector< long long > &weight,
+                         vector< vector< long long > > &cut );
+
+// Maximum flow
+void maximum_flow();
+
+// Maximum matching
+void maximum_matching();
+
+bool two_color( const vector< vector< int > > &adj, vector< int > &color );
+
+int greedy_matching( const vector< vector< int > > &adj, 
+                     vector< int > &match );
+
+int hopcroft_karp( const vector< vector< int > > &adj, 
+                   const vector< int > &color, vector< int > &match,
+                   int &phases );
+
+bool hopcroft_karp_levels( const vector< vector< int > > &adj, 
+                           const vector< int > &color, 
+                           const vector< int > &match, vector< int > &dist,
+                           int &freeDist );
+
+bool hopcroft_karp_augment( const vector< vector< int > > &adj, 
+                            vector< int > &match, vector< int > &dist,
+                            int freeDist, int x );
+
+int blossom_matching( BlossomSearch &search, int &augmentations );
+
+int blossom_path( BlossomSearch &search, int root );
+
+int blossom_lca( BlossomSearch &search, int a, int b );
+
+void blossom_mark( BlossomSearch &search, int v, int b, int child );
+
+// Bridges and articulation points
+void failure_points();
+
+int biconnected_components( const vector< WeightedEdge > &G, 
+                            const vector< vector< int > > &adj,
+                            vector< char > &bridge, vector< char > &cutVertex,
+                            vector< int > &component );
+
+// Travelling salesman tours
+void travelling_salesman();
+
+void city_neighbors( const TourMetric &metric, const vector< int > &cities,
+                     unsigned int k, vector< vector< int > > &near );
+
+void preorder_tour( unsigned int cityCount, 
+                    const vector< pair< int, int > > &treeEdges,
+                    vector< int > &tour );
+
+void christofides_tour( const TourMetric &metric, unsigned int cityCount,
+                        const vector< pair< int, int > > &treeEdges,
+                        vector< int > &tour );
+
+void greedy_pairing( const TourMetric &metric, const vector< int > &odd,
+                     vector< pair< int, int > > &pairs );
+
+double tour_length( const TourMetric &metric, const vector< int > &tour );
+
+long long improve_tour( const TourMetric &metric, 
+                        const vector< vector< int > > &near, 
+                        vector< int > &tour );
+
+void two_opt_move( vector< int > &tour, vector< int > &pos, 
+                   int a, int b, int c, int d );
+
+void reverse_tour( vector< int > &tour, vector< int > &pos, 
+                   int from, int to );
+
+// Exact tours
+void exact_tour();
+
+bool held_karp( const vector< vector< int > > &M, vector< int > &tour,
+                long long &weight );
+
+bool hamiltonian_cycle( const vector< vector< int > > &M );
+
+// Diameter
+void graph_diameter();
+
+void csr_adjacency( const vector< WeightedEdge > &G, unsigned int vertexCount,
+                    vector< int > &start, vector< int > &neighbor,
+                    vector< int > &weight );
+
+int bfs_eccentricity( const vector< int > &start, 
+                      const vector< int > &neighbor, int source, 
+                      vector< int > &dist, int &farthest );
+
+long long dijkstra_eccentricity( const vector< int > &start, 
+                                 const vector< int > &neighbor,
+                                 const vector< int > &weight, int source,
+                                 vector< long long > &dist, int &farthest );
+
+void ifub_diameter( const vector< int > &start, const vector< int > &neighbor,
+                    int root, long long budget, DiameterBounds &bounds );
+
+int diameter_sweep( const vector< int > &start, const vector< int > &neighbor,
+                    int source, vector< int > &dist, vector< int > &reach,
+                    vector< int > &high, DiameterBounds &bounds );
+
+void bounding_diameters( const vector< int > &start, 
+                         const vector< int > &neighbor,
+                         const vector< int > &weight, int root, 
+                         long long budget, DiameterBounds &bounds );
+
+// Betweenness centrality
+void betweenness_centrality();
+
+void brandes_betweenness( const vector< int > &start, 
+                          const vector< int > &neighbor,
+                          const vector< int > &weight, bool weighted,
+                          const vector< int > &sources, 
+                          vector< double > &centrality );
+
+// Spectra
+void spectral_invariants();
+
+void batch_jacobi( int n, int lanes, vector< double > &a, 
+                   vector< double > &eigenvalues, vector< double > *vectors );
+
+void graph_spectra( const vector< vector< int > > &M, 
+                    vector< double > &adjacency, vector< double > &laplacian );
+
+void laplacian_multiply( const vector< int > &start, 
+                         const vector< int > &neighbor,
+                         const vector< int > &weight, 
+                         const vector< double > &x, vector< double > &y );
+
+bool lanczos_fiedler( const vector< int > &start, 
+                      const vector< int > &neighbor,
+                      const vector< int > &weight, double &lambda,
+                      vector< double > &fiedler, int &restarts, 
+                      double &residual );
+
+// Random spanning trees
+void random_trees();
+
+bool is_connected( const vector< WeightedEdge > &G, 
+                   const vector< vector< int > > &adj );
+
+void wilson_tree( const vector< WeightedEdge > &G, 
+                  const vector< vector< int > > &adj, mt19937_64 &rng,
+                  vector< int > &treeEdges );
+
+// Canonical forms
+void canonical_hashing();
+
+void graph_to_matrix( const vector< WeightedEdge > &G, 
+                      unsigned int vertexCount, vector< vector< int > > &M );
+
+void matrix_to_graph( const vector< vector< int > > &M, 
+                      vector< WeightedEdge > &G );
+
+bool read_generated_graph( ifstream &inputFile, vector< vector< int > > &M );
+
+unsigned long long mix_hash( unsigned long long h, unsigned long long x );
+
+unsigned long long refine_colors( const vector< vector< int > > &M, 
+                                  vector< int > &color );
+
+int canonical_search( CanonicalSearch &search, const vector< int > &color,
+                      vector< int > &path );
+
+void canonical_labeling( const vector< vector< int > > &M, 
+                         vector< int > &label );
+
+GraphHash canonical_hash( const vector< vector< int > > &M, 
+                          vector< int > &label );
+
+string hash_text( const GraphHash &h );
+
+// Directed graphs
+void directed_arborescence();
+
+void create_digraph( ifstream &inputFile, vector< WeightedEdge > &G, 
+                     unsigned int &vertexCount );
+
+int merge_arc_heaps( vector< ArcHeapNode > &heap, int a, int b );
+
+void push_arc_offset( vector< ArcHeapNode > &heap, int x );
+
+bool min_arborescence( const vector< WeightedEdge > &G, 
+                       unsigned int vertexCount, int root,
+                       vector< int > &inArc, long long &totalWeight );
+
+// Cliques and colorings
+void clique_and_coloring();
+
+void build_bitgraph( const vector< vector< int > > &M, 
+                     const vector< int > &order, BitGraph &g );
+
+void color_sort( const BitGraph &g, vector< unsigned long long > P,
+                 vector< int > &order, vector< int > &colors );
+
+void clique_expand( const BitGraph &g, vector< int > &current,
+                    vector< unsigned long long > P, CliqueSearch &shared );
+
+int max_clique( const vector< vector< int > > &M, vector< int > &clique );
+
+void assign_color( ColoringSearch &search, int v, int c );
+
+void clear_color( ColoringSearch &search, int v );
+
+void dsatur_search( ColoringSearch &search, int colored, int used );
+
+int chromatic_number( const vector< vector< int > > &M, 
+                      const vector< int > &clique, vector< int > &coloring,
+                      bool &exact );
+
+// Clustering
+void single_linkage();
+
+void build_linkage( vector< WeightedEdge > &G, unsigned int vertexCount,
+                    const vector< int > &treeEdges, 
+                    vector< LinkageRow > &linkage );
+
+void cut_linkage( const vector< LinkageRow > &linkage, 
+                  unsigned int vertexCount, vector< int > thresholds );
 
 void make_graphs( const int vertex_count, const int combination_count );
 
@@ -103,6 +772,29 @@ int main()
 	{
 		case 1: spanning_tree(); 	break;
 		case 2: graph_generation(); break;
+		case 3: k_best_trees();     break;
+		case 4: euclidean_tree();   break;
+		case 5: single_linkage();   break;
+		case 6: random_trees();     break;
+		case 7: bottleneck_spanning_tree(); break;
+		case 8: steiner();          break;
+		case 9: degree_constrained_tree(); break;
+		case 10: canonical_hashing(); break;
+		case 11: clique_and_coloring(); break;
+		case 12: directed_arborescence(); break;
+		case 13: approximate_tree_weight(); break;
+		case 14: tree_sensitivity(); break;
+		case 15: graph_deltas(); break;
+		case 16: minimum_cut(); break;
+		case 17: gomory_hu(); break;
+		case 18: maximum_flow(); break;
+		case 19: maximum_matching(); break;
+		case 20: failure_points(); break;
+		case 21: travelling_salesman(); break;
+		case 22: exact_tour(); break;
+		case 23: graph_diameter(); break;
+		case 24: betweenness_centrality(); break;
+		case 25: spectral_invariants(); break;
 		/** room for more features... **/
 	}
 	
@@ -115,7 +807,7 @@ Description: Provides an interface for different graph operations
 =============================================================================*/
 int launch_menu()
 {
-	char c;		// Stores menu selection from user
+	int c;		// Stores menu selection from user
 	
 	printf("\n");
 	printf("--------------------------------------------\n");
@@ -128,25 +820,78 @@ int launch_menu()
 	{
 		printf(" 1: Spanning Tree\n");
 		printf(" 2: Graph Generation\n");
+		printf(" 3: k-Best Spanning Trees\n");
+		printf(" 4: Euclidean Spanning Tree\n");
+		printf(" 5: Single-Linkage Clustering\n");
+		printf(" 6: Random Spanning Trees\n");
+		printf(" 7: Bottleneck Spanning Tree\n");
+		printf(" 8: Steiner Tree\n");
+		printf(" 9: Degree-Constrained Spanning Tree\n");
+		printf(" 10: Canonical Graph Hashing\n");
+		printf(" 11: Clique and Chromatic Number\n");
+		printf(" 12: Directed Spanning Arborescence\n");
+		printf(" 13: Approximate Spanning Tree Weight\n");
+		printf(" 14: Spanning Tree Sensitivity\n");
+		printf(" 15: Apply Graph Deltas\n");
+		printf(" 16: Global Minimum Cut\n");
+		printf(" 17: Gomory-Hu Tree\n");
+		printf(" 18: Maximum Flow\n");
+		printf(" 19: Maximum Matching\n");
+		printf(" 20: Bridges and Articulation Points\n");
+		printf(" 21: Travelling Salesman Tour\n");
+		printf(" 22: Exact Tour (Held-Karp)\n");
+		printf(" 23: Graph Diameter\n");
+		printf(" 24: Betweenness Centrality\n");
+		printf(" 25: Spectral Invariants\n");
 		printf(" > ");
-		cin >> c;
+		
+		// Discard anything that is not a number
+		if ( !(cin >> c) )
+		{
+			cin.clear();
+			cin.ignore( numeric_limits< streamsize >::max(), '\n' );
+			c = 0;
+		}
 	} while ( !valid_choice(c) );
 	
 	printf("\n");
 	
-	return c-48; // ascii to integer
+	return c;
 }
 
 /*=============================================================================
 Function: launch_menu
 Description: Provides an interface for different graph operations
 =============================================================================*/
-bool valid_choice(char c)
+bool valid_choice(int c)
 {
 	switch (c)
 	{
-		case '1':	// Spanning Tree
-		case '2':	// Graph Generation
+		case 1:	// Spanning Tree
+		case 2:	// Graph Generation
+		case 3:	// k-Best Spanning Trees
+		case 4:	// Euclidean Spanning Tree
+		case 5:	// Single-Linkage Clustering
+		case 6:	// Random Spanning Trees
+		case 7:	// Bottleneck Spanning Tree
+		case 8:	// Steiner Tree
+		case 9:	// Degree-Constrained Spanning Tree
+		case 10:	// Canonical Graph Hashing
+		case 11:	// Clique and Chromatic Number
+		case 12:	// Directed Spanning Arborescence
+		case 13:	// Approximate Spanning Tree Weight
+		case 14:	// Spanning Tree Sensitivity
+		case 15:	// Apply Graph Deltas
+		case 16:	// Global Minimum Cut
+		case 17:	// Gomory-Hu Tree
+		case 18:	// Maximum Flow
+		case 19:	// Maximum Matching
+		case 20:	// Bridges and Articulation Points
+		case 21:	// Travelling Salesman Tour
+		case 22:	// Exact Tour (Held-Karp)
+		case 23:	// Graph Diameter
+		case 24:	// Betweenness Centrality
+		case 25:	// Spectral Invariants
 			return true;
 		default:
 			return false;
@@ -161,6 +906,7 @@ void spanning_tree()
 {
 	unsigned int vertexCount = 0;   // Stores vertex count from input file
     int totalWeight = 0;            // Tracks weight of T
+    int engine;                     // Algorithm used to find T
     ifstream inputFile;             // Stores input file data to read from
     vector< WeightedEdge > G;       // Our graph
     vector< WeightedEdge > T;       // Our tree
@@ -179,24 +925,37 @@ void spanning_tree()
     // Close input file
     inputFile.close();
     
-    /** Initialize saturated verticy group for T **/
-    vector< int > vT;            // Stores vertices of the graph T
-    vT.push_back( G[0].getU() ); // We can start anywhere, why not here
-    
-    /** Traverse G with Prim's algorithm to find T **/
-    // Until edge cardinality of T is one less than vertex cardinality of G
     do
     {
-        int min_incident_index;     // Stores index of edge to add to T
-        
-        // Find minimum incident edge to saturated verteces thus far
-        min_incident_index = min_incident( G, vT );
-        
-        // Add to tree, T
-        T.push_back( G[ min_incident_index ] );
-        totalWeight += G[ min_incident_index ].getW();
-        
-    } while ( T.size() < vertexCount-1 );
+        printf(" Which engine?\n");
+        printf(" 1: Prim\n");
+        printf(" 2: Karger-Klein-Tarjan (randomized)\n");
+        printf(" > ");
+        cin >> engine;
+    } while ( !(engine == 1 || engine == 2) );
+    cout << endl;
+    
+    /** Traverse G with the chosen engine to find T **/
+    vector< int > treeEdges;        // Indices in G of the edges of T
+    if ( engine == 1 )
+        totalWeight = prim_tree( G, vertexCount, treeEdges );
+    else
+        totalWeight = kkt_tree( G, vertexCount, treeEdges );
+    
+    for ( unsigned int i = 0; i < treeEdges.size(); i++ )
+    {
+        T.push_back( G[ treeEdges[i] ] );
+    }
+    
+    if ( treeEdges.size() + 1 < vertexCount )
+    {
+        if ( engine == 1 )
+            cout << "G is disconnected; T spans only one of its components." 
+                 << endl << endl;
+        else
+            cout << "G is disconnected; T is a minimum spanning forest." 
+                 << endl << endl;
+    }
     
     /** Print T **/
     cout << "The minimum spanning tree T of G:" 
@@ -247,16 +1006,17 @@ void graph_generation()
 Function: check_file
 Description: Opens and checks files, displaying message and exit upon error
 Parameters: inputFile - file storing weighted adjacency matrix
+            fileName - file to open, input.txt unless given
 =============================================================================*/
-bool check_file ( ifstream &inputFile )
+bool check_file ( ifstream &inputFile, const char *fileName )
 {
     // Open adjacency matrix file
-    inputFile.open( "input.txt" );
+    inputFile.open( fileName );
     
     if (!inputFile)
     {
         // Absent file
-        cout << "input.txt is absent from the exe directory." 
+        cout << fileName << " is absent from the exe directory." 
              << endl << endl << "Program terminated." << endl << endl;
             
         // Close file
@@ -319,63 +1079,577 @@ void create_graph( ifstream &inputFile, vector< WeightedEdge > &G,
     
 }
 
+/*=============================================================================
+Function: create_digraph
+Description: Reads the full matrix from the input file as a directed graph.
+             The entry in row r, column c is the cost of the arc r -> c,
+             stored as UVW vectors with u = r (tail) and v = c (head).
+             Unlike create_graph, both triangles are kept.
+Parameters: inputFile - file with weighted arc data
+            G - weighted arcs stored as UVW vector set
+            vertexCount - verticy cardinality for G
+=============================================================================*/
+void create_digraph( ifstream &inputFile, vector< WeightedEdge > &G, 
+                     unsigned int &vertexCount )
+{
+    // Read vertex count
+    inputFile >> vertexCount;
+    
+    // Iterate vertically
+    for (unsigned int j = 0; j < vertexCount; j++)
+    {
+        // Iterate horizontally
+        for (unsigned int i = 0; i < vertexCount; i++)
+        {
+            int k;
+            inputFile >> k;
+            
+            // Store every arc except loops
+            if (i != j && k != 0)
+            {
+                G.push_back( WeightedEdge(j,i,k) );
+            }
+        }
+    }
+}
+
 /*=============================================================================
 Function: min_incident
 Description: Returns the index in G for the vector with minimum weight incident
-             with the vertices in the set vT
+             with the vertices of the tree, and moves its outer vertex into
+             the tree. Returns -1 if no edge leaves the tree.
+             
+             Tree membership is a byte per vertex, and bestEdge caches the
+             lightest edge from each outside vertex into the tree, so a step
+             scans |V| cache entries instead of every edge of G.
 Parameters: G - weighted edges stored as UVW vector set
-            vT - verices of tree being built by Prim's algorithm
+            adj - incident edge indices of each vertex
+            inT - nonzero for vertices of the tree being built
+            bestEdge - lightest edge from each outside vertex into the tree,
+                       or -1
 =============================================================================*/
-int min_incident( vector< WeightedEdge > &G, vector< int > &vT )
+int min_incident( vector< WeightedEdge > &G, vector< vector< int > > &adj,
+                  vector< char > &inT, vector< int > &bestEdge )
 {
-    int minIndex = 0;       // Stores the index of the edge to add from G to T
+    int minVertex = -1;     // Outside vertex with the lightest crossing edge
     int minWeight;          // Used to track minimum weight
-    bool result_uMatch = 0; // True if u from our new edge already exists in T
-                            // False if v already exists in T
     
     // Initialize minweight at maximum weight
     minWeight = numeric_limits<int>::max();
     
-    // Search for incident edges outside the tree thus far
-    for ( unsigned int i = 0; i < G.size(); i++ )
+    // Search the crossing edge cache of the vertices outside the tree
+    for ( unsigned int x = 0; x < inT.size(); x++ )
     {
-        bool uMatch = 0; // True if the u vertex already exists in T 
-        bool vMatch = 0; // True if the v vertex already exists in T 
-        
-        // Check if the u and v of our edge already exists in T
-        for ( unsigned int j = 0; j < vT.size(); j++ )
-        {
-            if ( G[i].getU() == vT[j] ) uMatch = true;
-            if ( G[i].getV() == vT[j] ) vMatch = true;
-        }
+        if ( inT[x] || bestEdge[x] < 0 ) continue;
         
-        // Stores the minimum weight found for edges exterior to T so far
-        if ( uMatch+vMatch == 1 && G[i].getW() < minWeight)
+        if ( G[ bestEdge[x] ].getW() < minWeight )
         {
-            minWeight = G[i].getW();
-            minIndex = i;
-            result_uMatch = uMatch;
+            minWeight = G[ bestEdge[x] ].getW();
+            minVertex = x;
         }
     }
     
-    /** Append new vertex to vT from our minimum weight edge **/
-    // If u already exists in T, then add v, otherwise add u
-    vT.push_back( ( result_uMatch ) ? G[minIndex].getV() : G[minIndex].getU() );
+    if ( minVertex < 0 ) return -1;
     
-    return minIndex;
+    /** Append the new vertex to the tree **/
+    join_tree( G, adj, inT, bestEdge, minVertex );
+    
+    return bestEdge[ minVertex ];
 }
 
-
 /*=============================================================================
-Function: make_combinations
-Description: calculates reverse colexicographical permutations of a list of
-             number objects
-Parameters: input_count - defines the list of number objects by length
-            combination_count - length of permutations
+Function: join_tree
+Description: Moves a vertex into the tree and offers its edges to the
+             crossing edge cache of its outside neighbours
+Parameters: G - weighted edges stored as UVW vector set
+            adj - incident edge indices of each vertex
+            inT - nonzero for vertices of the tree being built
+            bestEdge - lightest edge from each outside vertex into the tree
+            x - vertex joining the tree
 =============================================================================*/
-void make_combinations( const int input_count, const int combination_count )
+void join_tree( vector< WeightedEdge > &G, vector< vector< int > > &adj,
+                vector< char > &inT, vector< int > &bestEdge, int x )
 {
-    int k=0;                            // Target object
+    inT[x] = 1;
+    
+    for ( unsigned int i = 0; i < adj[x].size(); i++ )
+    {
+        int e = adj[x][i];
+        int y = ( G[e].getU() == x ) ? G[e].getV() : G[e].getU();
+        
+        if ( inT[y] ) continue;
+        if ( bestEdge[y] < 0 || G[e].getW() < G[ bestEdge[y] ].getW() )
+            bestEdge[y] = e;
+    }
+}
+
+/*=============================================================================
+Function: prim_tree
+Description: Builds a minimum spanning tree of G with Prim's algorithm and
+             returns its total weight, in O(|V|^2 + |E|) time. If G is
+             disconnected only the component of the start vertex is spanned.
+Parameters: G - weighted edges stored as UVW vector set
+            vertexCount - verticy cardinality for G
+            treeEdges - receives the indices in G of the edges of T
+=============================================================================*/
+int prim_tree( vector< WeightedEdge > &G, unsigned int vertexCount,
+               vector< int > &treeEdges )
+{
+    int totalWeight = 0;                    // Tracks weight of T
+    vector< vector< int > > adj;            // Incident edges of each vertex
+    vector< char > inT( vertexCount, 0 );   // Marks vertices of T
+    vector< int > bestEdge( vertexCount, -1 ); 
+                                            // Lightest edge into T per vertex
+    
+    treeEdges.clear();
+    if ( G.empty() ) return 0;
+    
+    build_adjacency( G, vertexCount, adj );
+    
+    // We can start anywhere, why not here
+    join_tree( G, adj, inT, bestEdge, G[0].getU() );
+    
+    // Until edge cardinality of T is one less than vertex cardinality of G
+    while ( treeEdges.size() + 1 < vertexCount )
+    {
+        int min_incident_index = min_incident( G, adj, inT, bestEdge );
+        
+        if ( min_incident_index < 0 ) break;
+        
+        treeEdges.push_back( min_incident_index );
+        totalWeight += G[ min_incident_index ].getW();
+    }
+    
+    return totalWeight;
+}
+
+/*=============================================================================
+Function: load_graph
+Description: Reads G from input.txt, returning false if it is unusable
+Parameters: G - weighted edges stored as UVW vector set
+            vertexCount - verticy cardinality for G
+=============================================================================*/
+bool load_graph( vector< WeightedEdge > &G, unsigned int &vertexCount )
+{
+    ifstream inputFile;     // Stores input file data to read from
+    
+    if ( !check_file( inputFile ) ) return false;
+    
+    create_graph( inputFile, G, vertexCount );
+    inputFile.close();
+    
+    if ( G.empty() || vertexCount < 2 )
+    {
+        cout << "input.txt must describe a graph with at least one edge." 
+             << endl << endl;
+        return false;
+    }
+    return true;
+}
+
+/*=============================================================================
+Function: build_adjacency
+Description: Lists the indices of the edges incident to each vertex.
+             Self loops are left out.
+Parameters: G - weighted edges stored as UVW vector set
+            vertexCount - verticy cardinality for G
+            adj - receives the incident edge indices per vertex
+=============================================================================*/
+void build_adjacency( const vector< WeightedEdge > &G, 
+                      unsigned int vertexCount, vector< vector< int > > &adj )
+{
+    adj.assign( vertexCount, vector< int >() );
+    
+    for ( unsigned int i = 0; i < G.size(); i++ )
+    {
+        if ( G[i].getU() == G[i].getV() ) continue;
+        
+        adj[ G[i].getU() ].push_back( i );
+        adj[ G[i].getV() ].push_back( i );
+    }
+}
+
+/*=============================================================================
+Function: boruvka_step
+Description: One Boruvka round: every vertex picks its lightest incident edge
+             (ties broken by index), the picks are added to the forest and
+             their components contracted. The surviving edges between
+             different components are copied to H in their original order,
+             so index order still breaks weight ties the same way.
+Parameters: G - weighted edges stored as UVW vector set
+            vertexCount - verticy cardinality for G
+            forest - receives the indices in G of the picked edges
+            H - receives the contracted graph
+            origin - receives the index in G of each edge of H
+            contractedCount - receives the verticy cardinality of H
+=============================================================================*/
+void boruvka_step( const vector< WeightedEdge > &G, unsigned int vertexCount,
+                   vector< int > &forest, vector< WeightedEdge > &H,
+                   vector< int > &origin, unsigned int &contractedCount )
+{
+    vector< int > lightest( vertexCount, -1 );  // Lightest edge per vertex
+    vector< int > label( vertexCount, -1 );     // Vertex of H per component
+    DisjointSet components( vertexCount );      // Contracted components
+    
+    /** Find the lightest edge at each vertex **/
+    for ( unsigned int i = 0; i < G.size(); i++ )
+    {
+        int ends[2] = { G[i].getU(), G[i].getV() };
+        
+        if ( ends[0] == ends[1] ) continue;
+        
+        for ( int k = 0; k < 2; k++ )
+        {
+            int x = ends[k];
+            
+            // Edges are visited in index order, so only a lighter one wins
+            if ( lightest[x] < 0 || G[i].getW() < G[ lightest[x] ].getW() )
+                lightest[x] = i;
+        }
+    }
+    
+    /** Add the picks and contract **/
+    for ( unsigned int x = 0; x < vertexCount; x++ )
+    {
+        int e = lightest[x];
+        
+        if ( e >= 0 && components.join( G[e].getU(), G[e].getV() ) )
+            forest.push_back( e );
+    }
+    
+    contractedCount = 0;
+    for ( unsigned int x = 0; x < vertexCount; x++ )
+    {
+        int r = components.find( x );
+        
+        if ( label[r] < 0 ) label[r] = contractedCount++;
+    }
+    
+    /** Keep the edges between components **/
+    H.clear();
+    origin.clear();
+    for ( unsigned int i = 0; i < G.size(); i++ )
+    {
+        int a = label[ components.find( G[i].getU() ) ];
+        int b = label[ components.find( G[i].getV() ) ];
+        
+        if ( a == b ) continue;
+        
+        H.push_back( WeightedEdge( a, b, G[i].getW() ) );
+        origin.push_back( i );
+    }
+}
+
+/*=============================================================================
+Function: kkt_forest
+Description: Karger-Klein-Tarjan minimum spanning forest, expected O(|E|)
+             time. Two Boruvka rounds shrink the vertex count by at least
+             four; half the remaining edges are sampled and their forest F
+             found recursively; every edge that is F-heavy (heavier than all
+             of the F path between its ends) cannot be in the answer and is
+             dropped; the forest of the F-light edges is found recursively.
+             Weight ties are broken by index throughout, so the forest is
+             the unique minimum under that order.
+Parameters: G - weighted edges stored as UVW vector set
+            vertexCount - verticy cardinality for G
+            rng - random source for the edge samples
+            forest - receives the indices in G of the forest edges
+=============================================================================*/
+void kkt_forest( const vector< WeightedEdge > &G, unsigned int vertexCount,
+                 mt19937_64 &rng, vector< int > &forest )
+{
+    vector< WeightedEdge > H1, H2;  // Graphs after each Boruvka round
+    vector< int > origin1, origin2; // Index of each of their edges one up
+    vector< int > picked;           // Edges picked by the second round
+    unsigned int count1, count2;    // Vertex counts after each round
+    
+    if ( G.empty() ) return;
+    
+    /** Two Boruvka rounds **/
+    boruvka_step( G, vertexCount, forest, H1, origin1, count1 );
+    boruvka_step( H1, count1, picked, H2, origin2, count2 );
+    for ( unsigned int i = 0; i < picked.size(); i++ )
+        forest.push_back( origin1[ picked[i] ] );
+    
+    if ( H2.empty() ) return;
+    
+    /** Forest of a random half of the edges **/
+    vector< WeightedEdge > sample;  // Sampled edges of H2
+    vector< int > sampleOrigin;     // Index in H2 of each sampled edge
+    vector< int > sampleForest;     // Forest of the sample
+    
+    for ( unsigned int i = 0; i < H2.size(); i++ )
+    {
+        if ( rng() & 1 )
+        {
+            sample.push_back( H2[i] );
+            sampleOrigin.push_back( i );
+        }
+    }
+    kkt_forest( sample, count2, rng, sampleForest );
+    for ( unsigned int i = 0; i < sampleForest.size(); i++ )
+        sampleForest[i] = sampleOrigin[ sampleForest[i] ];
+    
+    /** Drop the edges that are heavy for the sampled forest **/
+    vector< WeightedEdge > light;   // F-light edges of H2
+    vector< int > lightOrigin;      // Index in H2 of each light edge
+    vector< int > lightForest;      // Forest of the light edges
+    {
+        PathMaxTree paths( H2, count2, sampleForest, vector< char >() );
+        
+        for ( unsigned int i = 0; i < H2.size(); i++ )
+        {
+            int m = paths.query( H2[i].getU(), H2[i].getV() );
+            
+            if ( m >= 0 && ( H2[m].getW() < H2[i].getW() || 
+                 ( H2[m].getW() == H2[i].getW() && m < (int)i ) ) )
+                continue;
+            
+            light.push_back( H2[i] );
+            lightOrigin.push_back( i );
+        }
+    }
+    
+    /** Forest of the light edges **/
+    kkt_forest( light, count2, rng, lightForest );
+    for ( unsigned int i = 0; i < lightForest.size(); i++ )
+        forest.push_back( origin1[ origin2[ lightOrigin[ lightForest[i] ] ] ] );
+}
+
+/*=============================================================================
+Function: kkt_tree
+Description: Builds a minimum spanning forest of G with the randomized
+             Karger-Klein-Tarjan engine and returns its total weight
+Parameters: G - weighted edges stored as UVW vector set
+            vertexCount - verticy cardinality for G
+            treeEdges - receives the indices in G of the edges of T
+=============================================================================*/
+int kkt_tree( vector< WeightedEdge > &G, unsigned int vertexCount,
+              vector< int > &treeEdges )
+{
+    int totalWeight = 0;            // Tracks weight of T
+    mt19937_64 rng( vertexCount );  // Samples only affect running time,
+                                    // the forest is the same for any seed
+    
+    treeEdges.clear();
+    kkt_forest( G, vertexCount, rng, treeEdges );
+    sort( treeEdges.begin(), treeEdges.end() );
+    
+    for ( unsigned int i = 0; i < treeEdges.size(); i++ )
+        totalWeight += G[ treeEdges[i] ].getW();
+    
+    return totalWeight;
+}
+
+/*=============================================================================
+Function: DisjointSet::join
+Description: Merges the sets holding a and b, hanging the smaller set below
+             the larger. Returns false if they were already one set.
+Parameters: a, b - elements to merge
+=============================================================================*/
+bool DisjointSet::join( int a, int b )
+{
+    a = find(a);
+    b = find(b);
+    
+    if ( a == b ) return false;
+    
+    if ( size[a] < size[b] ) swap( a, b );
+    parent[b] = a;
+    size[a] += size[b];
+    
+    return true;
+}
+
+/*=============================================================================
+Function: RollbackSet::join
+Description: Merges the sets holding a and b, logging every write so it can
+             be undone. Returns false if they were already one set.
+Parameters: a, b - elements to merge
+=============================================================================*/
+bool RollbackSet::join( int a, int b )
+{
+    a = find(a);
+    b = find(b);
+    
+    if ( a == b ) return false;
+    
+    // parent holds minus the set size at roots
+    if ( parent[a] > parent[b] ) swap( a, b );
+    history.push_back( make_pair( a, parent[a] ) );
+    parent[a] += parent[b];
+    history.push_back( make_pair( b, parent[b] ) );
+    parent[b] = a;
+    
+    return true;
+}
+
+/*=============================================================================
+Function: RollbackSet::rollback
+Description: Undoes every write made after a time returned by time()
+Parameters: t - time to return to
+=============================================================================*/
+void RollbackSet::rollback( int t )
+{
+    while ( (int)history.size() > t )
+    {
+        parent[ history.back().first ] = history.back().second;
+        history.pop_back();
+    }
+}
+
+/*=============================================================================
+Function: PathMaxTree (constructor)
+Description: Roots every tree of the forest and builds the binary lifting
+             tables used for heaviest-edge path queries
+Parameters: G - weighted edges stored as UVW vector set
+            vertexCount - verticy cardinality for G
+            treeEdges - indices in G of the edges of the forest
+            locked - per edge of G, nonzero if it may not be reported
+                     (may be empty)
+=============================================================================*/
+PathMaxTree::PathMaxTree( const vector< WeightedEdge > &G, 
+                          unsigned int vertexCount,
+                          const vector< int > &treeEdges,
+                          const vector< char > &locked )
+{
+    int levels = 1;                     // Number of lifting levels
+    vector< vector< int > > adj;        // Tree edges incident to each vertex
+    vector< int > order;                // Vertices in breadth first order
+    
+    edges = &G;
+    
+    while ( ( 1u << levels ) < vertexCount ) levels++;
+    
+    depth.assign( vertexCount, -1 );
+    component.assign( vertexCount, -1 );
+    up.assign( levels, vector< int >( vertexCount ) );
+    upMax.assign( levels, vector< int >( vertexCount, -1 ) );
+    
+    adj.assign( vertexCount, vector< int >() );
+    for ( unsigned int i = 0; i < treeEdges.size(); i++ )
+    {
+        adj[ G[ treeEdges[i] ].getU() ].push_back( treeEdges[i] );
+        adj[ G[ treeEdges[i] ].getV() ].push_back( treeEdges[i] );
+    }
+    
+    /** Root each tree and record parents breadth first **/
+    for ( unsigned int r = 0; r < vertexCount; r++ )
+    {
+        if ( depth[r] != -1 ) continue;
+        
+        depth[r] = 0;
+        component[r] = r;
+        up[0][r] = r;
+        order.push_back( r );
+        
+        for ( unsigned int head = order.size() - 1; head < order.size(); 
+              head++ )
+        {
+            int x = order[head];
+            
+            for ( unsigned int i = 0; i < adj[x].size(); i++ )
+            {
+                int e = adj[x][i];
+                int y = ( G[e].getU() == x ) ? G[e].getV() : G[e].getU();
+                
+                if ( depth[y] != -1 ) continue;
+                
+                depth[y] = depth[x] + 1;
+                component[y] = r;
+                up[0][y] = x;
+                upMax[0][y] = ( !locked.empty() && locked[e] ) ? -1 : e;
+                order.push_back( y );
+            }
+        }
+    }
+    
+    /** Double the jumps **/
+    for ( int k = 1; k < levels; k++ )
+    {
+        for ( unsigned int x = 0; x < vertexCount; x++ )
+        {
+            int mid = up[k-1][x];
+            
+            up[k][x] = up[k-1][mid];
+            upMax[k][x] = heavier( upMax[k-1][x], upMax[k-1][mid] );
+        }
+    }
+}
+
+/*=============================================================================
+Function: PathMaxTree::heavier
+Description: Returns the heavier of two edge indices, breaking weight ties by
+             index so every edge has a distinct rank. -1 means no edge.
+Parameters: a, b - edge indices in G, or -1
+=============================================================================*/
+int PathMaxTree::heavier( int a, int b ) const
+{
+    if ( a < 0 ) return b;
+    if ( b < 0 ) return a;
+    
+    int wa = (*edges)[a].getW();
+    int wb = (*edges)[b].getW();
+    
+    if ( wa != wb ) return ( wa > wb ) ? a : b;
+    return ( a > b ) ? a : b;
+}
+
+/*=============================================================================
+Function: PathMaxTree::query
+Description: Returns the index in G of the heaviest unlocked edge on the tree
+             path between a and b. Returns -1 if a and b lie in different
+             trees or every edge on the path is locked.
+Parameters: a, b - vertices of the forest
+=============================================================================*/
+int PathMaxTree::query( int a, int b ) const
+{
+    int result = -1;    // Heaviest edge found so far
+    
+    if ( component[a] != component[b] ) return -1;
+    
+    // Lift the deeper vertex to the depth of the other
+    if ( depth[a] < depth[b] ) swap( a, b );
+    for ( int k = up.size() - 1; k >= 0; k-- )
+    {
+        if ( depth[a] - ( 1 << k ) >= depth[b] )
+        {
+            result = heavier( result, upMax[k][a] );
+            a = up[k][a];
+        }
+    }
+    
+    if ( a == b ) return result;
+    
+    // Lift both to just below their lowest common ancestor
+    for ( int k = up.size() - 1; k >= 0; k-- )
+    {
+        if ( up[k][a] != up[k][b] )
+        {
+            result = heavier( result, upMax[k][a] );
+            result = heavier( result, upMax[k][b] );
+            a = up[k][a];
+            b = up[k][b];
+        }
+    }
+    
+    result = heavier( result, upMax[0][a] );
+    result = heavier( result, upMax[0][b] );
+    
+    return result;
+}
+
+
+/*=============================================================================
+Function: make_combinations
+Description: calculates reverse colexicographical permutations of a list of
+             number objects
+Parameters: input_count - defines the list of number objects by length
+            combination_count - length of permutations
+=============================================================================*/
+void make_combinations( const int input_count, const int combination_count )
+{
+    int k=0;                            // Target object
     int indices[combination_count];     // integers to uhh permutate
    
     // Check that we have enough to populate each array
@@ -617,8 +1891,7568 @@ int triangle_number( int k )
     
     
 
+/*=============================================================================
+Function: k_best_trees
+Description: Lists the k cheapest spanning trees of the input graph in order
+             of weight. The second tree listed is the second-best MST.
+=============================================================================*/
+void k_best_trees()
+{
+    unsigned int vertexCount = 0;   // Stores vertex count from input file
+    int k;                          // Number of trees requested
+    vector< WeightedEdge > G;       // Our graph
+    vector< TreePartition > trees;  // The trees found, lightest first
+    
+    if ( !load_graph( G, vertexCount ) ) return;
+    
+    do
+    {
+        printf(" How many spanning trees? (2 gives the second-best MST)\n");
+        printf(" > ");
+        cin >> k;
+    } while ( !(k > 0) );
+    cout << endl;
+    
+    if ( !best_trees( G, vertexCount, k, trees ) )
+    {
+        cout << "G is disconnected and has no spanning tree."
+             << endl << endl;
+        return;
+    }
+    
+    for ( unsigned int found = 0; found < trees.size(); found++ )
+    {
+        vector< WeightedEdge > T;
+        for ( unsigned int i = 0; i < trees[found].tree.size(); i++ )
+            T.push_back( G[ trees[found].tree[i] ] );
+        
+        cout << "Spanning tree " << found + 1 
+             << " (weight " << trees[found].weight << "):" << endl;
+        print_graph(T);
+    }
+    
+    if ( (int)trees.size() < k )
+        cout << "G has only " << trees.size() << " spanning trees." 
+             << endl << endl;
+}
 
-
-
-
-
+/*=============================================================================
+Function: best_trees
+Description: Finds the k cheapest spanning trees of G in order of weight,
+             or all of them if G has fewer. Returns false if G is
+             disconnected.
+             
+             The trees are enumerated lazily by partitioning the tree space
+             (Katoh-Ibaraki-Mine): each subproblem forces some edges in and
+             some out, and knows its best tree and the cheapest single edge
+             exchange inside it. Popping the subproblem with the cheapest
+             exchange yields the next tree, then the subproblem is split on
+             the removed edge. Only the first tree runs Prim; every later
+             tree costs two O(|E| log |V|) exchange searches.
+Parameters: G - weighted edges stored as UVW vector set
+            vertexCount - verticy cardinality for G
+            k - number of trees wanted
+            trees - receives each tree and its weight, lightest first
+=============================================================================*/
+bool best_trees( vector< WeightedEdge > &G, unsigned int vertexCount, int k,
+                 vector< TreePartition > &trees )
+{
+    vector< TreePartition > parts;  // Subproblems of the partition
+    priority_queue< pair< int, int >, vector< pair< int, int > >,
+                    greater< pair< int, int > > > open;
+                                    // (next tree weight, subproblem index)
+    
+    trees.clear();
+    
+    /** The best tree of the unconstrained problem is the MST **/
+    TreePartition root;
+    root.weight = prim_tree( G, vertexCount, root.tree );
+    root.state.assign( G.size(), 0 );
+    
+    // Prim spans only the start vertex's component
+    if ( root.tree.size() + 1 != vertexCount ) return false;
+    
+    trees.push_back( root );
+    trees.back().state.clear();
+    
+    if ( best_swap( G, vertexCount, root ) )
+    {
+        parts.push_back( root );
+        open.push( make_pair( root.nextWeight, 0 ) );
+    }
+    
+    /** Pop the cheapest exchange, report it and split its subproblem **/
+    while ( (int)trees.size() < k && !open.empty() )
+    {
+        int p = open.top().second;
+        open.pop();
+        
+        // Subproblem with the exchanged edge excluded: its best tree is new
+        TreePartition without;
+        without.state = parts[p].state;
+        without.state[ parts[p].swapOut ] = 2;
+        without.weight = parts[p].nextWeight;
+        for ( unsigned int i = 0; i < parts[p].tree.size(); i++ )
+        {
+            int e = parts[p].tree[i];
+            without.tree.push_back( ( e == parts[p].swapOut ) 
+                                    ? parts[p].swapIn : e );
+        }
+        
+        trees.push_back( TreePartition() );
+        trees.back().tree = without.tree;
+        trees.back().weight = without.weight;
+        
+        // Subproblem with the exchanged edge forced in: same best tree
+        TreePartition with;
+        with.state = parts[p].state;
+        with.state[ parts[p].swapOut ] = 1;
+        with.tree.swap( parts[p].tree );
+        with.weight = parts[p].weight;
+        
+        // Release the popped subproblem
+        vector< int >().swap( parts[p].tree );
+        vector< char >().swap( parts[p].state );
+        
+        if ( best_swap( G, vertexCount, with ) )
+        {
+            parts.push_back( with );
+            open.push( make_pair( with.nextWeight, parts.size() - 1 ) );
+        }
+        if ( best_swap( G, vertexCount, without ) )
+        {
+            parts.push_back( without );
+            open.push( make_pair( without.nextWeight, parts.size() - 1 ) );
+        }
+    }
+    
+    return true;
+}
+
+/*=============================================================================
+Function: best_swap
+Description: Finds the cheapest exchange of one free tree edge for one
+             allowed non-tree edge in a subproblem. For each candidate edge
+             (u, v) the edge it replaces is the heaviest free edge on the
+             tree path u..v. Returns false if no exchange exists.
+Parameters: G - weighted edges stored as UVW vector set
+            vertexCount - verticy cardinality for G
+            part - subproblem; its swap fields are filled in
+=============================================================================*/
+bool best_swap( vector< WeightedEdge > &G, unsigned int vertexCount,
+                TreePartition &part )
+{
+    vector< char > inTree( G.size(), 0 );   // Marks edges of part.tree
+    vector< char > locked( G.size(), 0 );   // Marks forced edges
+    bool found = false;                     // True once an exchange is seen
+    
+    for ( unsigned int i = 0; i < part.tree.size(); i++ )
+        inTree[ part.tree[i] ] = 1;
+    for ( unsigned int i = 0; i < G.size(); i++ )
+        locked[i] = ( part.state[i] == 1 );
+    
+    PathMaxTree pathMax( G, vertexCount, part.tree, locked );
+    
+    for ( unsigned int i = 0; i < G.size(); i++ )
+    {
+        if ( inTree[i] || part.state[i] == 2 ) continue;
+        if ( G[i].getU() == G[i].getV() ) continue;
+        
+        int out = pathMax.query( G[i].getU(), G[i].getV() );
+        if ( out < 0 ) continue;
+        
+        int weight = part.weight - G[out].getW() + G[i].getW();
+        if ( !found || weight < part.nextWeight )
+        {
+            found = true;
+            part.nextWeight = weight;
+            part.swapOut = out;
+            part.swapIn = i;
+        }
+    }
+    
+    return found;
+}
+
+/*=============================================================================
+Function: euclidean_tree
+Description: Calculates the Euclidean minimum spanning tree of the points in
+             points.txt without building a distance matrix
+=============================================================================*/
+void euclidean_tree()
+{
+    PointCloud P;                   // Points read from points.txt
+    vector< GeometricEdge > T;      // Our tree
+    double totalLength;             // Tracks length of T
+    
+    if ( !read_points( P ) ) return;
+    
+    totalLength = euclidean_mst( P, T );
+    
+    /** Print T **/
+    cout << "The Euclidean minimum spanning tree T of the " << P.count 
+         << " points:" << endl;
+    for ( unsigned int i = 0; i < T.size(); i++ )
+    {
+        cout << "   Edge " << i << ": verts<" << T[i].u << ", " << T[i].v 
+             << "> length[ " << T[i].length << " ]" << endl;
+    }
+    cout << endl;
+    
+    // Print length
+    cout << "Total length of T: " << endl 
+         << "   " << totalLength << endl << endl;
+}
+
+/*=============================================================================
+Function: read_points
+Description: Reads a point cloud from points.txt. The file holds the point
+             count and the dimension, followed by one line of coordinates
+             per point.
+Parameters: P - receives the points
+=============================================================================*/
+bool read_points( PointCloud &P )
+{
+    ifstream inputFile;     // Stores input file data to read from
+    
+    if ( !check_file( inputFile, "points.txt" ) ) return false;
+    
+    inputFile >> P.count >> P.dimension;
+    
+    if ( !inputFile || P.count < 2 || P.dimension < 1 )
+    {
+        cout << "points.txt must start with a point count of at least 2 "
+             << "and a dimension." << endl << endl;
+        inputFile.close();
+        return false;
+    }
+    
+    P.coord.resize( (size_t)P.count * P.dimension );
+    for ( size_t i = 0; i < P.coord.size(); i++ )
+    {
+        inputFile >> P.coord[i];
+    }
+    
+    if ( !inputFile )
+    {
+        cout << "points.txt ended before all coordinates were read." 
+             << endl << endl;
+        inputFile.close();
+        return false;
+    }
+    
+    inputFile.close();
+    return true;
+}
+
+/*=============================================================================
+Function: euclidean_mst
+Description: Builds the Euclidean minimum spanning tree of a point cloud with
+             Boruvka's algorithm over a kd-tree and returns its length.
+             
+             Each round labels the kd-tree nodes whose points all lie in one
+             component, then finds for every point its nearest point in
+             another component. Uniform nodes of the querying component are
+             skipped, and each query starts from the best distance found
+             for its component so far. Components at least halve per round,
+             so memory stays O(n) and time is about O(n log^2 n) for points
+             in general position.
+Parameters: P - points to span
+            T - receives the tree edges
+=============================================================================*/
+double euclidean_mst( const PointCloud &P, vector< GeometricEdge > &T )
+{
+    KdTree tree( P );                       // Spatial index of P
+    DisjointSet components( P.count );      // Components of T so far
+    vector< int > label( P.count );         // Component of each point
+    vector< double > bestDist( P.count );   // Shortest exit per component
+    vector< int > bestFrom( P.count );      // Its endpoint in the component
+    vector< int > bestTo( P.count );        // Its endpoint outside
+    double totalLength = 0;                 // Tracks length of T
+    
+    T.clear();
+    for ( int i = 0; i < P.count; i++ ) label[i] = i;
+    
+    while ( (int)T.size() < P.count - 1 )
+    {
+        tree.label_nodes( label );
+        
+        for ( int i = 0; i < P.count; i++ )
+        {
+            bestDist[i] = numeric_limits< double >::infinity();
+            bestTo[i] = -1;
+        }
+        
+        /** Find the shortest edge leaving each component **/
+        for ( int p = 0; p < P.count; p++ )
+        {
+            int c = label[p];
+            int q = -1;
+            
+            tree.nearest_foreign( p, label, bestDist[c], q );
+            if ( q >= 0 )
+            {
+                bestFrom[c] = p;
+                bestTo[c] = q;
+            }
+        }
+        
+        /** Add them, skipping those that close a cycle on ties **/
+        for ( int c = 0; c < P.count; c++ )
+        {
+            if ( bestTo[c] < 0 ) continue;
+            
+            if ( components.join( bestFrom[c], bestTo[c] ) )
+            {
+                GeometricEdge e;
+                e.u = bestFrom[c];
+                e.v = bestTo[c];
+                e.length = sqrt( bestDist[c] );
+                T.push_back( e );
+                totalLength += e.length;
+            }
+        }
+        
+        for ( int i = 0; i < P.count; i++ ) label[i] = components.find(i);
+    }
+    
+    return totalLength;
+}
+
+/*=============================================================================
+Function: KdTree (constructor)
+Description: Builds the tree by median splits along the widest box side
+Parameters: P - points to index
+=============================================================================*/
+KdTree::KdTree( const PointCloud &P )
+{
+    points = &P;
+    order.resize( P.count );
+    for ( int i = 0; i < P.count; i++ ) order[i] = i;
+    
+    build( 0, P.count );
+    nodeLabel.assign( nodeBegin.size(), -1 );
+}
+
+/*=============================================================================
+Function: KdTree::build
+Description: Creates the node for order[begin..end) and its subtrees, and
+             returns its index. Children always follow their parent.
+Parameters: begin, end - range of order covered by the node
+=============================================================================*/
+int KdTree::build( int begin, int end )
+{
+    const int LEAF_SIZE = 8;            // Most points kept in a leaf
+    const int D = points->dimension;
+    int node = nodeBegin.size();        // Index of the new node
+    int widest = 0;                     // Axis with the widest extent
+    
+    nodeBegin.push_back( begin );
+    nodeEnd.push_back( end );
+    nodeLeft.push_back( -1 );
+    nodeRight.push_back( -1 );
+    
+    /** Bounding box **/
+    for ( int k = 0; k < D; k++ )
+    {
+        double lo = numeric_limits< double >::infinity();
+        double hi = -lo;
+        
+        for ( int i = begin; i < end; i++ )
+        {
+            double x = points->coord[ (size_t)order[i] * D + k ];
+            lo = min( lo, x );
+            hi = max( hi, x );
+        }
+        boxLo.push_back( lo );
+        boxHi.push_back( hi );
+        
+        if ( hi - lo > boxHi[ (size_t)node*D + widest ] 
+                       - boxLo[ (size_t)node*D + widest ] )
+            widest = k;
+    }
+    
+    if ( end - begin <= LEAF_SIZE ) return node;
+    
+    /** Split at the median of the widest axis **/
+    int mid = begin + ( end - begin ) / 2;
+    const vector< double > &coord = points->coord;
+    
+    nth_element( order.begin() + begin, order.begin() + mid, 
+                 order.begin() + end,
+                 [&]( int a, int b ) 
+                 { return coord[ (size_t)a*D + widest ] 
+                        < coord[ (size_t)b*D + widest ]; } );
+    
+    int left = build( begin, mid );
+    int right = build( mid, end );
+    nodeLeft[node] = left;
+    nodeRight[node] = right;
+    
+    return node;
+}
+
+/*=============================================================================
+Function: KdTree::distance
+Description: Returns the squared Euclidean distance between two points
+Parameters: a, b - point indices
+=============================================================================*/
+double KdTree::distance( int a, int b ) const
+{
+    const int D = points->dimension;
+    double sum = 0;
+    
+    for ( int k = 0; k < D; k++ )
+    {
+        double d = points->coord[ (size_t)a*D + k ] 
+                 - points->coord[ (size_t)b*D + k ];
+        sum += d * d;
+    }
+    return sum;
+}
+
+/*=============================================================================
+Function: KdTree::box_distance
+Description: Returns the squared distance from a point to a node's box
+Parameters: node - tree node
+            p - point index
+=============================================================================*/
+double KdTree::box_distance( int node, int p ) const
+{
+    const int D = points->dimension;
+    double sum = 0;
+    
+    for ( int k = 0; k < D; k++ )
+    {
+        double x = points->coord[ (size_t)p*D + k ];
+        double d = 0;
+        
+        if ( x < boxLo[ (size_t)node*D + k ] ) 
+            d = boxLo[ (size_t)node*D + k ] - x;
+        else if ( x > boxHi[ (size_t)node*D + k ] ) 
+            d = x - boxHi[ (size_t)node*D + k ];
+        sum += d * d;
+    }
+    return sum;
+}
+
+/*=============================================================================
+Function: KdTree::label_nodes
+Description: Marks every node whose points all share one label with that
+             label, and every other node with -1
+Parameters: label - label of each point
+=============================================================================*/
+void KdTree::label_nodes( const vector< int > &label )
+{
+    // Children follow their parents, so walk the nodes backwards
+    for ( int node = nodeBegin.size() - 1; node >= 0; node-- )
+    {
+        if ( nodeLeft[node] < 0 )
+        {
+            int common = label[ order[ nodeBegin[node] ] ];
+            
+            for ( int i = nodeBegin[node] + 1; i < nodeEnd[node]; i++ )
+            {
+                if ( label[ order[i] ] != common ) common = -1;
+            }
+            nodeLabel[node] = common;
+        }
+        else
+        {
+            int l = nodeLabel[ nodeLeft[node] ];
+            nodeLabel[node] = ( l == nodeLabel[ nodeRight[node] ] ) ? l : -1;
+        }
+    }
+}
+
+/*=============================================================================
+Function: KdTree::search_foreign
+Description: Recursive part of nearest_foreign
+Parameters: node - subtree to search
+            p - query point
+            label - label of each point
+            bestDist - squared distance to beat, lowered on success
+            best - receives the nearest point found
+=============================================================================*/
+void KdTree::search_foreign( int node, int p, const vector< int > &label,
+                             double &bestDist, int &best ) const
+{
+    // Skip subtrees of p's own component and subtrees too far away
+    if ( nodeLabel[node] == label[p] ) return;
+    if ( box_distance( node, p ) >= bestDist ) return;
+    
+    if ( nodeLeft[node] < 0 )
+    {
+        for ( int i = nodeBegin[node]; i < nodeEnd[node]; i++ )
+        {
+            int q = order[i];
+            if ( label[q] == label[p] ) continue;
+            
+            double d = distance( p, q );
+            if ( d < bestDist )
+            {
+                bestDist = d;
+                best = q;
+            }
+        }
+        return;
+    }
+    
+    // Visit the nearer child first
+    int near = nodeLeft[node];
+    int far = nodeRight[node];
+    if ( box_distance( far, p ) < box_distance( near, p ) ) swap( near, far );
+    
+    search_foreign( near, p, label, bestDist, best );
+    search_foreign( far, p, label, bestDist, best );
+}
+
+/*=============================================================================
+Function: KdTree::nearest
+Description: Finds the k nearest points to p, leaving p itself out
+Parameters: p - query point
+            k - number of neighbours wanted
+            result - receives them, nearest first
+=============================================================================*/
+void KdTree::nearest( int p, unsigned int k, vector< int > &result ) const
+{
+    vector< pair< double, int > > heap;     // (squared distance, point),
+                                            // farthest on top
+    
+    search_nearest( 0, p, k, heap );
+    sort_heap( heap.begin(), heap.end() );
+    
+    result.clear();
+    for ( unsigned int i = 0; i < heap.size(); i++ )
+        result.push_back( heap[i].second );
+}
+
+/*=============================================================================
+Function: KdTree::search_nearest
+Description: Recursive part of nearest
+Parameters: node - subtree to search
+            p - query point
+            k - number of neighbours wanted
+            heap - the best k found so far, as a max-heap on distance
+=============================================================================*/
+void KdTree::search_nearest( int node, int p, unsigned int k,
+                             vector< pair< double, int > > &heap ) const
+{
+    if ( heap.size() == k && box_distance( node, p ) >= heap.front().first )
+        return;
+    
+    if ( nodeLeft[node] < 0 )
+    {
+        for ( int i = nodeBegin[node]; i < nodeEnd[node]; i++ )
+        {
+            int q = order[i];
+            if ( q == p ) continue;
+            
+            double d = distance( p, q );
+            if ( heap.size() < k )
+            {
+                heap.push_back( make_pair( d, q ) );
+                push_heap( heap.begin(), heap.end() );
+            }
+            else if ( d < heap.front().first )
+            {
+                pop_heap( heap.begin(), heap.end() );
+                heap.back() = make_pair( d, q );
+                push_heap( heap.begin(), heap.end() );
+            }
+        }
+        return;
+    }
+    
+    // Visit the nearer child first
+    int near = nodeLeft[node];
+    int far = nodeRight[node];
+    if ( box_distance( far, p ) < box_distance( near, p ) ) swap( near, far );
+    
+    search_nearest( near, p, k, heap );
+    search_nearest( far, p, k, heap );
+}
+
+/*=============================================================================
+Function: single_linkage
+Description: Builds the single-linkage dendrogram of the input graph from its
+             minimum spanning forest, writes the linkage array to linkage.txt
+             and prints the clusters at any number of cut heights. The
+             components of a disconnected graph are never merged, so the
+             dendrogram then has one top cluster per component.
+=============================================================================*/
+void single_linkage()
+{
+    unsigned int vertexCount = 0;   // Stores vertex count from input file
+    int cutCount;                   // Number of cut heights requested
+    vector< WeightedEdge > G;       // Our graph
+    vector< int > treeEdges;        // Indices in G of the forest edges
+    vector< LinkageRow > linkage;   // Merges in order of height
+    vector< int > thresholds;       // Cut heights
+    ofstream outfile;               // Stores output file data for linkage
+    
+    if ( !load_graph( G, vertexCount ) ) return;
+    
+    kkt_tree( G, vertexCount, treeEdges );
+    build_linkage( G, vertexCount, treeEdges, linkage );
+    
+    /** Write and print the linkage array **/
+    outfile.open( "linkage.txt" );
+    outfile << vertexCount << endl;
+    
+    cout << "Single-linkage merges (cluster, cluster, height, size):" << endl;
+    for ( unsigned int i = 0; i < linkage.size(); i++ )
+    {
+        outfile << linkage[i].first << " " << linkage[i].second << " "
+                << linkage[i].height << " " << linkage[i].size << endl;
+        cout << "   Cluster " << vertexCount + i << ": " 
+             << linkage[i].first << " + " << linkage[i].second 
+             << " at height " << linkage[i].height 
+             << ", size " << linkage[i].size << endl;
+    }
+    if ( linkage.size() + 1 < vertexCount )
+        cout << endl << "G has " << vertexCount - linkage.size() 
+             << " components, which never merge." << endl;
+    cout << endl << "Linkage array written to linkage.txt" << endl << endl;
+    outfile.close();
+    
+    /** Cut the dendrogram **/
+    do
+    {
+        printf(" Cut at how many heights? (0 for none)\n");
+        printf(" > ");
+        cin >> cutCount;
+    } while ( !(cutCount >= 0) );
+    
+    for ( int i = 0; i < cutCount; i++ )
+    {
+        int h;
+        printf(" Height %d > ", i + 1);
+        cin >> h;
+        thresholds.push_back( h );
+    }
+    cout << endl;
+    
+    if ( cutCount > 0 ) cut_linkage( linkage, vertexCount, thresholds );
+}
+
+/*=============================================================================
+Function: build_linkage
+Description: Replays the tree edges in order of weight through a union-find,
+             recording each merge as a linkage row
+Parameters: G - weighted edges stored as UVW vector set
+            vertexCount - verticy cardinality for G
+            treeEdges - indices in G of the edges of the spanning forest
+            linkage - receives one row per forest edge
+=============================================================================*/
+void build_linkage( vector< WeightedEdge > &G, unsigned int vertexCount,
+                    const vector< int > &treeEdges, 
+                    vector< LinkageRow > &linkage )
+{
+    vector< int > order( treeEdges );       // Tree edges sorted by weight
+    DisjointSet sets( vertexCount );        // Clusters merged so far
+    vector< int > clusterOf( vertexCount ); // Cluster index of each root
+    vector< int > sizeOf( vertexCount, 1 ); // Vertex count of each root
+    
+    for ( unsigned int i = 0; i < vertexCount; i++ ) clusterOf[i] = i;
+    
+    stable_sort( order.begin(), order.end(), 
+                 [&]( int a, int b ) { return G[a].getW() < G[b].getW(); } );
+    
+    linkage.clear();
+    for ( unsigned int i = 0; i < order.size(); i++ )
+    {
+        int a = sets.find( G[ order[i] ].getU() );
+        int b = sets.find( G[ order[i] ].getV() );
+        
+        if ( a == b ) continue;
+        
+        LinkageRow row;
+        row.first = min( clusterOf[a], clusterOf[b] );
+        row.second = max( clusterOf[a], clusterOf[b] );
+        row.height = G[ order[i] ].getW();
+        row.size = sizeOf[a] + sizeOf[b];
+        
+        sets.join( a, b );
+        int root = sets.find( a );
+        clusterOf[root] = vertexCount + linkage.size();
+        sizeOf[root] = row.size;
+        
+        linkage.push_back( row );
+    }
+}
+
+/*=============================================================================
+Function: cut_linkage
+Description: Prints the flat clustering at each cut height. The heights are
+             visited in increasing order while the linkage is replayed once,
+             so k cuts cost one pass over the merges plus k label sweeps.
+Parameters: linkage - merges in order of height
+            vertexCount - verticy cardinality for G
+            thresholds - cut heights; merges at or below a height are kept
+=============================================================================*/
+void cut_linkage( const vector< LinkageRow > &linkage, 
+                  unsigned int vertexCount, vector< int > thresholds )
+{
+    DisjointSet sets( 2 * vertexCount );    // Clusters by linkage index
+    unsigned int next = 0;                  // Next merge to apply
+    
+    sort( thresholds.begin(), thresholds.end() );
+    
+    for ( unsigned int t = 0; t < thresholds.size(); t++ )
+    {
+        // Apply merges up to this height
+        while ( next < linkage.size() && linkage[next].height <= thresholds[t] )
+        {
+            sets.join( linkage[next].first, vertexCount + next );
+            sets.join( linkage[next].second, vertexCount + next );
+            next++;
+        }
+        
+        // Number clusters in order of their first vertex
+        vector< int > number( 2 * vertexCount, -1 );
+        int clusters = 0;
+        
+        cout << "Cut at height " << thresholds[t] << ": " 
+             << vertexCount - next << " clusters" << endl << "  ";
+        for ( unsigned int v = 0; v < vertexCount; v++ )
+        {
+            int root = sets.find(v);
+            if ( number[root] < 0 ) number[root] = clusters++;
+            cout << " " << number[root];
+        }
+        cout << endl << endl;
+    }
+}
+
+/*=============================================================================
+Function: random_trees
+Description: Samples uniformly random spanning trees of the input graph with
+             Wilson's algorithm and streams them to random_trees.txt.
+             
+             Trees are drawn in batches; the trees of a batch are sampled in
+             parallel, then written in order before the next batch starts.
+             Sample i always uses the random stream seeded by (seed, i), so
+             the output does not depend on the thread count.
+=============================================================================*/
+void random_trees()
+{
+    const int BATCH = 256;              // Trees sampled between writes
+    unsigned int vertexCount = 0;       // Stores vertex count from input file
+    int sampleCount;                    // Number of trees requested
+    unsigned int seed;                  // Base seed of the random streams
+    vector< WeightedEdge > G;           // Our graph
+    vector< vector< int > > adj;        // Incident edges of each vertex
+    vector< int > frequency;            // Trees containing each edge
+    ofstream outfile;                   // Stores output file data for trees
+    
+    if ( !load_graph( G, vertexCount ) ) return;
+    
+    build_adjacency( G, vertexCount, adj );
+    if ( !is_connected( G, adj ) )
+    {
+        cout << "G is disconnected and has no spanning tree." 
+             << endl << endl;
+        return;
+    }
+    
+    do
+    {
+        printf(" How many spanning trees?\n");
+        printf(" > ");
+        cin >> sampleCount;
+    } while ( !(sampleCount > 0) );
+    
+    printf(" Random seed?\n");
+    printf(" > ");
+    cin >> seed;
+    cout << endl;
+    
+    frequency.assign( G.size(), 0 );
+    outfile.open( "random_trees.txt" );
+    
+    /** Sample and write batch by batch **/
+    for ( int first = 0; first < sampleCount; first += BATCH )
+    {
+        int count = min( BATCH, sampleCount - first );
+        vector< vector< int > > trees( count );
+        
+        #pragma omp parallel for schedule(dynamic)
+        for ( int b = 0; b < count; b++ )
+        {
+            seed_seq stream{ seed, (unsigned int)( first + b ) };
+            mt19937_64 rng( stream );
+            
+            wilson_tree( G, adj, rng, trees[b] );
+        }
+        
+        for ( int b = 0; b < count; b++ )
+        {
+            outfile << "Tree " << first + b + 1 << endl;
+            for ( unsigned int i = 0; i < trees[b].size(); i++ )
+            {
+                const WeightedEdge &e = G[ trees[b][i] ];
+                outfile << e.getU() << " " << e.getV() << " " << e.getW() 
+                        << endl;
+                frequency[ trees[b][i] ]++;
+            }
+            outfile << endl;
+        }
+    }
+    outfile.close();
+    
+    /** Print how often each edge was used **/
+    cout << sampleCount << " spanning trees written to random_trees.txt" 
+         << endl << endl << "Share of trees containing each edge of G:" 
+         << endl;
+    for ( unsigned int i = 0; i < G.size(); i++ )
+    {
+        cout << "   Edge " << i << ": ";
+        G[i].print_edge();
+        cout << " in " << 100.0 * frequency[i] / sampleCount << "%" << endl;
+    }
+    cout << endl;
+}
+
+/*=============================================================================
+Function: is_connected
+Description: Returns true if every vertex is reachable from vertex 0
+Parameters: G - weighted edges stored as UVW vector set
+            adj - incident edge indices of each vertex
+=============================================================================*/
+bool is_connected( const vector< WeightedEdge > &G, 
+                   const vector< vector< int > > &adj )
+{
+    vector< char > seen( adj.size(), 0 );   // Marks reached vertices
+    vector< int > stack( 1, 0 );            // Vertices left to expand
+    unsigned int reached = 1;               // Number of reached vertices
+    
+    if ( adj.empty() ) return true;
+    seen[0] = 1;
+    
+    while ( !stack.empty() )
+    {
+        int x = stack.back();
+        stack.pop_back();
+        
+        for ( unsigned int i = 0; i < adj[x].size(); i++ )
+        {
+            const WeightedEdge &e = G[ adj[x][i] ];
+            int y = ( e.getU() == x ) ? e.getV() : e.getU();
+            
+            if ( seen[y] ) continue;
+            seen[y] = 1;
+            reached++;
+            stack.push_back( y );
+        }
+    }
+    
+    return reached == adj.size();
+}
+
+/*=============================================================================
+Function: wilson_tree
+Description: Draws one spanning tree uniformly at random, ignoring weights.
+             From each vertex outside the tree a random walk runs until it
+             hits the tree; remembering only the last exit from each vertex
+             erases the walk's loops, and the remaining path is added.
+Parameters: G - weighted edges stored as UVW vector set (must be connected)
+            adj - incident edge indices of each vertex
+            rng - random stream of this sample
+            treeEdges - receives the indices in G of the tree edges
+=============================================================================*/
+void wilson_tree( const vector< WeightedEdge > &G, 
+                  const vector< vector< int > > &adj, mt19937_64 &rng,
+                  vector< int > &treeEdges )
+{
+    int vertexCount = adj.size();
+    vector< char > inTree( vertexCount, 0 );    // Marks vertices of the tree
+    vector< int > exitEdge( vertexCount, -1 );  // Last edge the walk took
+                                                // out of each vertex
+    
+    treeEdges.clear();
+    inTree[ uniform_int_distribution< int >( 0, vertexCount - 1 )( rng ) ] = 1;
+    
+    for ( int start = 0; start < vertexCount; start++ )
+    {
+        // Walk until the tree is hit
+        for ( int x = start; !inTree[x]; )
+        {
+            uniform_int_distribution< int > pick( 0, adj[x].size() - 1 );
+            int e = adj[x][ pick( rng ) ];
+            
+            exitEdge[x] = e;
+            x = ( G[e].getU() == x ) ? G[e].getV() : G[e].getU();
+        }
+        
+        // Add the loop-erased path
+        for ( int x = start; !inTree[x]; )
+        {
+            int e = exitEdge[x];
+            
+            inTree[x] = 1;
+            treeEdges.push_back( e );
+            x = ( G[e].getU() == x ) ? G[e].getV() : G[e].getU();
+        }
+    }
+}
+
+/*=============================================================================
+Function: bottleneck_spanning_tree
+Description: Calculates a minimum bottleneck spanning tree of the input
+             graph and its bottleneck (heaviest edge weight)
+=============================================================================*/
+void bottleneck_spanning_tree()
+{
+    unsigned int vertexCount = 0;   // Stores vertex count from input file
+    int bottleneck;                 // Heaviest edge weight of T
+    vector< WeightedEdge > G;       // Our graph
+    vector< WeightedEdge > T;       // Our tree
+    vector< int > treeEdges;        // Indices in G of the edges of T
+    
+    if ( !load_graph( G, vertexCount ) ) return;
+    
+    if ( !bottleneck_tree( G, vertexCount, treeEdges, bottleneck ) )
+    {
+        cout << "G is disconnected and has no spanning tree." 
+             << endl << endl;
+        return;
+    }
+    
+    for ( unsigned int i = 0; i < treeEdges.size(); i++ )
+        T.push_back( G[ treeEdges[i] ] );
+    
+    /** Print T **/
+    cout << "A minimum bottleneck spanning tree T of G:" << endl;
+    print_graph(T);
+    
+    cout << "Bottleneck weight of T: " << endl 
+         << "   " << bottleneck << endl << endl;
+}
+
+/*=============================================================================
+Function: bottleneck_tree
+Description: Builds a minimum bottleneck spanning tree with Camerini's
+             algorithm and stores its bottleneck. Returns false if G is
+             disconnected.
+             
+             The live edges are split at their median weight. If the lighter
+             half connects the live graph, the heavier half is dropped.
+             Otherwise a spanning forest of the lighter half joins T, its
+             components are contracted and the heavier half is kept. Each
+             round halves the live edges, so the expected time is O(|E|).
+Parameters: G - weighted edges stored as UVW vector set
+            vertexCount - verticy cardinality for G
+            treeEdges - receives the indices in G of the edges of T
+            bottleneck - receives the heaviest edge weight of T
+=============================================================================*/
+bool bottleneck_tree( vector< WeightedEdge > &G, unsigned int vertexCount,
+                      vector< int > &treeEdges, int &bottleneck )
+{
+    int n = vertexCount;        // Vertices of the contracted graph
+    vector< int > live;         // Indices in G of the live edges
+    vector< int > endA;         // Contracted endpoints of each live edge
+    vector< int > endB;
+    
+    treeEdges.clear();
+    for ( unsigned int i = 0; i < G.size(); i++ )
+    {
+        if ( G[i].getU() == G[i].getV() ) continue;
+        
+        live.push_back( i );
+        endA.push_back( G[i].getU() );
+        endB.push_back( G[i].getV() );
+    }
+    
+    while ( n > 1 )
+    {
+        if ( live.empty() ) return false;
+        
+        if ( live.size() == 1 )
+        {
+            // A single edge can only span two vertices
+            if ( n != 2 ) return false;
+            treeEdges.push_back( live[0] );
+            break;
+        }
+        
+        /** Split the live edges at the median weight **/
+        unsigned int lowCount = ( live.size() - 1 ) / 2 + 1;
+        vector< int > order( live.size() );     // Positions in live
+        
+        for ( unsigned int i = 0; i < order.size(); i++ ) order[i] = i;
+        nth_element( order.begin(), order.begin() + lowCount - 1, order.end(),
+                     [&]( int a, int b ) 
+                     { return G[ live[a] ].getW() < G[ live[b] ].getW(); } );
+        
+        /** Check whether the lighter half connects the graph **/
+        DisjointSet sets( n );          // Components of the lighter half
+        vector< int > forest;           // Lighter edges joining components
+        int components = n;
+        
+        for ( unsigned int i = 0; i < lowCount; i++ )
+        {
+            if ( sets.join( endA[ order[i] ], endB[ order[i] ] ) )
+            {
+                forest.push_back( live[ order[i] ] );
+                components--;
+            }
+        }
+        
+        vector< int > nextLive;
+        vector< int > nextA;
+        vector< int > nextB;
+        
+        if ( components == 1 )
+        {
+            // Keep only the lighter half
+            for ( unsigned int i = 0; i < lowCount; i++ )
+            {
+                nextLive.push_back( live[ order[i] ] );
+                nextA.push_back( endA[ order[i] ] );
+                nextB.push_back( endB[ order[i] ] );
+            }
+        }
+        else
+        {
+            // Commit the lighter forest and contract its components
+            vector< int > label( n, -1 );
+            int next = 0;
+            
+            treeEdges.insert( treeEdges.end(), forest.begin(), forest.end() );
+            for ( int x = 0; x < n; x++ )
+            {
+                if ( label[ sets.find(x) ] < 0 ) label[ sets.find(x) ] = next++;
+            }
+            
+            for ( unsigned int i = lowCount; i < order.size(); i++ )
+            {
+                int a = label[ sets.find( endA[ order[i] ] ) ];
+                int b = label[ sets.find( endB[ order[i] ] ) ];
+                
+                if ( a == b ) continue;
+                nextLive.push_back( live[ order[i] ] );
+                nextA.push_back( a );
+                nextB.push_back( b );
+            }
+            n = components;
+        }
+        
+        live.swap( nextLive );
+        endA.swap( nextA );
+        endB.swap( nextB );
+    }
+    
+    // A single vertex has an empty tree and no heaviest edge
+    bottleneck = 0;
+    for ( unsigned int i = 0; i < treeEdges.size(); i++ )
+    {
+        if ( i == 0 || G[ treeEdges[i] ].getW() > bottleneck )
+            bottleneck = G[ treeEdges[i] ].getW();
+    }
+    
+    return true;
+}
+
+/*=============================================================================
+Function: steiner
+Description: Connects a chosen set of terminal vertices of the input graph
+             with a Steiner tree at most twice the optimal weight
+=============================================================================*/
+void steiner()
+{
+    unsigned int vertexCount = 0;   // Stores vertex count from input file
+    int terminalCount;              // Number of terminals
+    long long totalWeight;          // Tracks weight of the tree
+    vector< WeightedEdge > G;       // Our graph
+    vector< WeightedEdge > T;       // Our tree
+    vector< int > terminals;        // Vertices the tree must connect
+    vector< int > treeEdges;        // Indices in G of the edges of T
+    
+    if ( !load_graph( G, vertexCount ) ) return;
+    
+    do
+    {
+        printf(" How many terminal vertices?\n");
+        printf(" > ");
+        cin >> terminalCount;
+    } while ( !(terminalCount > 0) || terminalCount > (int)vertexCount );
+    
+    for ( int i = 0; i < terminalCount; i++ )
+    {
+        int t;
+        do
+        {
+            printf(" Terminal %d > ", i + 1);
+            cin >> t;
+        } while ( !(t >= 0 && t < (int)vertexCount) );
+        terminals.push_back( t );
+    }
+    cout << endl;
+    
+    totalWeight = steiner_tree( G, vertexCount, terminals, treeEdges );
+    if ( totalWeight < 0 )
+    {
+        cout << "The terminals do not lie in one component of G." 
+             << endl << endl;
+        return;
+    }
+    
+    for ( unsigned int i = 0; i < treeEdges.size(); i++ )
+        T.push_back( G[ treeEdges[i] ] );
+    
+    /** Print T **/
+    cout << "A Steiner tree T connecting the terminals:" << endl;
+    print_graph(T);
+    
+    cout << "Total weight of T: " << endl 
+         << "   " << totalWeight << endl << endl;
+}
+
+/*=============================================================================
+Function: steiner_tree
+Description: Builds a Steiner tree with Mehlhorn's 2-approximation and
+             returns its weight, or -1 if the terminals are not connected.
+             
+             One multi-source Dijkstra from all terminals splits G into
+             Voronoi regions. Every edge between two regions stands for a
+             terminal-to-terminal path; a spanning tree over those paths
+             (Kruskal) replaces the metric closure. The chosen paths are
+             expanded, spanned again, and leaves that are not terminals are
+             pruned. Total time O(|E| log |V|).
+Parameters: G - weighted edges stored as UVW vector set
+            vertexCount - verticy cardinality for G
+            terminals - vertices the tree must connect
+            treeEdges - receives the indices in G of the tree edges
+=============================================================================*/
+long long steiner_tree( vector< WeightedEdge > &G, unsigned int vertexCount,
+                        const vector< int > &terminals, 
+                        vector< int > &treeEdges )
+{
+    const long long UNREACHED = numeric_limits< long long >::max();
+    vector< vector< int > > adj;                // Incident edges per vertex
+    vector< long long > dist( vertexCount, UNREACHED ); 
+                                                // Distance to nearest terminal
+    vector< int > source( vertexCount, -1 );    // That terminal
+    vector< int > pred( vertexCount, -1 );      // Last edge on the way there
+    priority_queue< pair< long long, int >, vector< pair< long long, int > >,
+                    greater< pair< long long, int > > > heap;
+    long long totalWeight = 0;                  // Tracks weight of the tree
+    
+    treeEdges.clear();
+    build_adjacency( G, vertexCount, adj );
+    
+    /** Voronoi regions of the terminals **/
+    for ( unsigned int i = 0; i < terminals.size(); i++ )
+    {
+        dist[ terminals[i] ] = 0;
+        source[ terminals[i] ] = terminals[i];
+        heap.push( make_pair( 0LL, terminals[i] ) );
+    }
+    
+    while ( !heap.empty() )
+    {
+        long long d = heap.top().first;
+        int x = heap.top().second;
+        heap.pop();
+        
+        if ( d > dist[x] ) continue;
+        
+        for ( unsigned int i = 0; i < adj[x].size(); i++ )
+        {
+            int e = adj[x][i];
+            int y = ( G[e].getU() == x ) ? G[e].getV() : G[e].getU();
+            
+            if ( d + G[e].getW() < dist[y] )
+            {
+                dist[y] = d + G[e].getW();
+                source[y] = source[x];
+                pred[y] = e;
+                heap.push( make_pair( dist[y], y ) );
+            }
+        }
+    }
+    
+    /** Span the terminals through edges between regions **/
+    vector< pair< long long, int > > bridges;   // (path length, edge)
+    DisjointSet regions( vertexCount );         // Terminals joined so far
+    vector< char > used( G.size(), 0 );         // Edges on chosen paths
+    unsigned int joined = 0;                    // Paths chosen
+    
+    for ( unsigned int i = 0; i < G.size(); i++ )
+    {
+        int u = G[i].getU();
+        int v = G[i].getV();
+        
+        if ( source[u] < 0 || source[v] < 0 || source[u] == source[v] ) 
+            continue;
+        bridges.push_back( make_pair( dist[u] + G[i].getW() + dist[v], i ) );
+    }
+    sort( bridges.begin(), bridges.end() );
+    
+    for ( unsigned int i = 0; i < bridges.size(); i++ )
+    {
+        int e = bridges[i].second;
+        
+        if ( !regions.join( source[ G[e].getU() ], source[ G[e].getV() ] ) ) 
+            continue;
+        joined++;
+        
+        // Expand into the path terminal..u - v..terminal
+        used[e] = 1;
+        for ( int x = G[e].getU(); pred[x] >= 0 && !used[ pred[x] ]; )
+        {
+            used[ pred[x] ] = 1;
+            x = ( G[ pred[x] ].getU() == x ) ? G[ pred[x] ].getV() 
+                                             : G[ pred[x] ].getU();
+        }
+        for ( int x = G[e].getV(); pred[x] >= 0 && !used[ pred[x] ]; )
+        {
+            used[ pred[x] ] = 1;
+            x = ( G[ pred[x] ].getU() == x ) ? G[ pred[x] ].getV() 
+                                             : G[ pred[x] ].getU();
+        }
+    }
+    
+    // Count distinct terminals; every pair must have been joined
+    vector< int > distinct( terminals );
+    sort( distinct.begin(), distinct.end() );
+    distinct.erase( unique( distinct.begin(), distinct.end() ), 
+                    distinct.end() );
+    if ( joined + 1 < distinct.size() ) return -1;
+    
+    /** Span the expanded paths again **/
+    vector< int > chosen;               // Edges of the expanded paths
+    vector< int > degree( vertexCount, 0 );
+    DisjointSet sets( vertexCount );
+    
+    for ( unsigned int i = 0; i < G.size(); i++ )
+        if ( used[i] ) chosen.push_back( i );
+    stable_sort( chosen.begin(), chosen.end(), 
+                 [&]( int a, int b ) { return G[a].getW() < G[b].getW(); } );
+    
+    for ( unsigned int i = 0; i < chosen.size(); i++ )
+    {
+        int e = chosen[i];
+        
+        if ( sets.join( G[e].getU(), G[e].getV() ) )
+        {
+            treeEdges.push_back( e );
+            degree[ G[e].getU() ]++;
+            degree[ G[e].getV() ]++;
+        }
+    }
+    
+    /** Prune leaves that are not terminals **/
+    vector< char > isTerminal( vertexCount, 0 );
+    vector< vector< int > > treeAdj;
+    vector< char > removed( G.size(), 0 );
+    vector< int > leaves;
+    
+    for ( unsigned int i = 0; i < terminals.size(); i++ )
+        isTerminal[ terminals[i] ] = 1;
+    treeAdj.assign( vertexCount, vector< int >() );
+    for ( unsigned int i = 0; i < treeEdges.size(); i++ )
+    {
+        treeAdj[ G[ treeEdges[i] ].getU() ].push_back( treeEdges[i] );
+        treeAdj[ G[ treeEdges[i] ].getV() ].push_back( treeEdges[i] );
+    }
+    
+    for ( unsigned int x = 0; x < vertexCount; x++ )
+        if ( degree[x] == 1 && !isTerminal[x] ) leaves.push_back( x );
+    
+    while ( !leaves.empty() )
+    {
+        int x = leaves.back();
+        leaves.pop_back();
+        
+        for ( unsigned int i = 0; i < treeAdj[x].size(); i++ )
+        {
+            int e = treeAdj[x][i];
+            if ( removed[e] ) continue;
+            
+            int y = ( G[e].getU() == x ) ? G[e].getV() : G[e].getU();
+            removed[e] = 1;
+            degree[x]--;
+            if ( --degree[y] == 1 && !isTerminal[y] ) leaves.push_back( y );
+        }
+    }
+    
+    vector< int > kept;
+    for ( unsigned int i = 0; i < treeEdges.size(); i++ )
+    {
+        if ( removed[ treeEdges[i] ] ) continue;
+        kept.push_back( treeEdges[i] );
+        totalWeight += G[ treeEdges[i] ].getW();
+    }
+    treeEdges.swap( kept );
+    
+    return totalWeight;
+}
+
+/*=============================================================================
+Function: degree_constrained_tree
+Description: Searches for a light spanning tree of the input graph whose
+             vertex degrees stay within per-vertex caps, and reports how far
+             it can be from optimal.
+             
+             Each restart grows a tree with a degree-aware Prim (restarts
+             after the first perturb the weights) and repairs it by edge
+             exchanges. Restarts run in parallel. A Lagrangian relaxation
+             of the degree caps gives the lower bound for the gap.
+=============================================================================*/
+void degree_constrained_tree()
+{
+    unsigned int vertexCount = 0;   // Stores vertex count from input file
+    int maxDegree;                  // Cap applied to every vertex
+    int overrides;                  // Number of vertex-specific caps
+    int restarts;                   // Number of independent restarts
+    unsigned int seed;              // Base seed of the restart streams
+    vector< WeightedEdge > G;       // Our graph
+    vector< vector< int > > adj;    // Incident edges of each vertex
+    vector< int > cap;              // Degree cap of each vertex
+    
+    if ( !load_graph( G, vertexCount ) ) return;
+    
+    build_adjacency( G, vertexCount, adj );
+    if ( !is_connected( G, adj ) )
+    {
+        cout << "G is disconnected and has no spanning tree." 
+             << endl << endl;
+        return;
+    }
+    
+    /** Read the caps **/
+    do
+    {
+        printf(" Maximum degree of every vertex?\n");
+        printf(" > ");
+        cin >> maxDegree;
+    } while ( !(maxDegree > 0) );
+    cap.assign( vertexCount, maxDegree );
+    
+    do
+    {
+        printf(" How many vertices have their own cap? (0 for none)\n");
+        printf(" > ");
+        cin >> overrides;
+    } while ( !(overrides >= 0) );
+    
+    for ( int i = 0; i < overrides; i++ )
+    {
+        int v, c;
+        do
+        {
+            printf(" Vertex and cap %d > ", i + 1);
+            cin >> v >> c;
+        } while ( !(v >= 0 && v < (int)vertexCount && c > 0) );
+        cap[v] = c;
+    }
+    
+    do
+    {
+        printf(" How many restarts?\n");
+        printf(" > ");
+        cin >> restarts;
+    } while ( !(restarts > 0) );
+    
+    printf(" Random seed?\n");
+    printf(" > ");
+    cin >> seed;
+    cout << endl;
+    
+    /** Independent restarts **/
+    vector< vector< int > > trees( restarts );
+    vector< long long > weights( restarts );
+    
+    #pragma omp parallel for schedule(dynamic)
+    for ( int r = 0; r < restarts; r++ )
+    {
+        seed_seq stream{ seed, (unsigned int)r };
+        mt19937_64 rng( stream );
+        
+        weights[r] = capped_prim( G, adj, cap, rng, ( r == 0 ) ? 0.0 : 0.1,
+                                  trees[r] );
+        if ( weights[r] >= 0 )
+            weights[r] = repair_capped_tree( G, vertexCount, cap, trees[r] );
+    }
+    
+    int best = -1;      // Restart with the lightest tree
+    for ( int r = 0; r < restarts; r++ )
+    {
+        if ( weights[r] >= 0 && ( best < 0 || weights[r] < weights[best] ) ) 
+            best = r;
+    }
+    
+    if ( best < 0 )
+    {
+        cout << "No restart found a spanning tree within the degree caps." 
+             << endl << endl;
+        return;
+    }
+    
+    /** Print T and its gap **/
+    vector< WeightedEdge > T;
+    for ( unsigned int i = 0; i < trees[best].size(); i++ )
+        T.push_back( G[ trees[best][i] ] );
+    
+    double lowerBound = capped_lower_bound( G, vertexCount, cap, 
+                                            weights[best] );
+    
+    cout << "The lightest degree-constrained spanning tree T found:" << endl;
+    print_graph(T);
+    
+    cout << "Total weight of T: " << endl 
+         << "   " << weights[best] << endl
+         << "Lagrangian lower bound: " << endl 
+         << "   " << lowerBound << endl
+         << "Gap to the lower bound: " << endl 
+         << "   " << 100.0 * ( weights[best] - lowerBound ) / 
+                     max( 1LL, weights[best] ) << "%" << endl << endl;
+}
+
+/*=============================================================================
+Function: capped_prim
+Description: Grows a spanning tree like Prim's algorithm, but never attaches
+             to a tree vertex that has reached its cap. Candidate edges sit in
+             a lazy heap; an edge whose tree endpoint fills up is dropped.
+             Returns the tree weight, or -1 if the caps left it stuck.
+Parameters: G - weighted edges stored as UVW vector set
+            adj - incident edge indices of each vertex
+            cap - degree cap of each vertex
+            rng - random stream of this restart
+            noise - relative weight perturbation (0 for plain Prim order)
+            treeEdges - receives the indices in G of the tree edges
+=============================================================================*/
+long long capped_prim( const vector< WeightedEdge > &G, 
+                       const vector< vector< int > > &adj,
+                       const vector< int > &cap, mt19937_64 &rng, 
+                       double noise, vector< int > &treeEdges )
+{
+    int vertexCount = adj.size();
+    vector< char > inTree( vertexCount, 0 );    // Marks vertices of the tree
+    vector< int > degree( vertexCount, 0 );     // Tree degree of each vertex
+    vector< double > key( G.size() );           // Perturbed edge weights
+    priority_queue< pair< double, int >, vector< pair< double, int > >,
+                    greater< pair< double, int > > > heap;
+                                                // (key, edge) candidates
+    uniform_real_distribution< double > jitter( 0.0, noise );
+    long long totalWeight = 0;                  // Tracks weight of the tree
+    
+    for ( unsigned int i = 0; i < G.size(); i++ )
+        key[i] = G[i].getW() * ( 1.0 + jitter( rng ) );
+    
+    treeEdges.clear();
+    int start = uniform_int_distribution< int >( 0, vertexCount - 1 )( rng );
+    
+    // Joining a vertex offers its edges to the outside
+    int x = start;
+    while ( true )
+    {
+        inTree[x] = 1;
+        for ( unsigned int i = 0; i < adj[x].size(); i++ )
+        {
+            int e = adj[x][i];
+            int y = ( G[e].getU() == x ) ? G[e].getV() : G[e].getU();
+            if ( !inTree[y] ) heap.push( make_pair( key[e], e ) );
+        }
+        
+        if ( (int)treeEdges.size() == vertexCount - 1 ) break;
+        
+        // Cheapest edge from an unsaturated tree vertex to the outside
+        x = -1;
+        while ( !heap.empty() && x < 0 )
+        {
+            int e = heap.top().second;
+            int a = G[e].getU();
+            int b = G[e].getV();
+            heap.pop();
+            
+            if ( inTree[a] == inTree[b] ) continue;
+            
+            int inner = inTree[a] ? a : b;
+            if ( degree[inner] >= cap[inner] ) continue;
+            
+            x = inTree[a] ? b : a;
+            degree[a]++;
+            degree[b]++;
+            treeEdges.push_back( e );
+            totalWeight += G[e].getW();
+        }
+        
+        if ( x < 0 ) return -1;
+    }
+    
+    return totalWeight;
+}
+
+/*=============================================================================
+Function: repair_capped_tree
+Description: Improves a capped tree by edge exchanges. A non-tree edge (a, b)
+             may replace a heavier edge f on the tree path a..b when a and b
+             stay within their caps once f is gone. Passes repeat, lightest
+             candidates first, until none improves. Returns the new weight.
+             
+             The tree is rooted once with parent edges and depths, and the
+             path a..b is read by climbing from the deeper end. Rooting is
+             redone only after an exchange, so a pass without one costs the
+             total path length instead of a search per candidate.
+Parameters: G - weighted edges stored as UVW vector set
+            vertexCount - verticy cardinality for G
+            cap - degree cap of each vertex
+            treeEdges - tree edge indices in G, updated in place
+=============================================================================*/
+long long repair_capped_tree( const vector< WeightedEdge > &G, 
+                              unsigned int vertexCount,
+                              const vector< int > &cap, 
+                              vector< int > &treeEdges )
+{
+    const int MAX_PASSES = 50;              // Bound on exchange passes
+    vector< char > inTree( G.size(), 0 );   // Marks tree edges
+    vector< int > degree( vertexCount, 0 ); // Tree degree of each vertex
+    vector< int > order;                    // Non-tree edges by weight
+    vector< vector< int > > treeAdj;        // Tree edges at each vertex
+    vector< int > parentEdge;               // Edge to the parent, -1 at root
+    vector< int > depth;                    // Depth below vertex 0
+    long long totalWeight = 0;              // Tracks weight of the tree
+    bool improved = true;                   // True while exchanges happen
+    bool rooted = false;                    // True while parents are current
+    
+    for ( unsigned int i = 0; i < treeEdges.size(); i++ )
+    {
+        inTree[ treeEdges[i] ] = 1;
+        degree[ G[ treeEdges[i] ].getU() ]++;
+        degree[ G[ treeEdges[i] ].getV() ]++;
+    }
+    for ( unsigned int i = 0; i < G.size(); i++ )
+        if ( G[i].getU() != G[i].getV() ) order.push_back( i );
+    stable_sort( order.begin(), order.end(), 
+                 [&]( int a, int b ) { return G[a].getW() < G[b].getW(); } );
+    
+    for ( int pass = 0; pass < MAX_PASSES && improved; pass++ )
+    {
+        improved = false;
+        
+        for ( unsigned int k = 0; k < order.size(); k++ )
+        {
+            int e = order[k];
+            int a = G[e].getU();
+            int b = G[e].getV();
+            
+            if ( inTree[e] ) continue;
+            
+            /** Root the tree at vertex 0 after an exchange **/
+            if ( !rooted )
+            {
+                treeAdj.assign( vertexCount, vector< int >() );
+                parentEdge.assign( vertexCount, -2 );
+                depth.assign( vertexCount, 0 );
+                
+                for ( unsigned int i = 0; i < treeEdges.size(); i++ )
+                {
+                    int f = treeEdges[i];
+                    treeAdj[ G[f].getU() ].push_back( f );
+                    treeAdj[ G[f].getV() ].push_back( f );
+                }
+                
+                vector< int > stack( 1, 0 );
+                parentEdge[0] = -1;
+                while ( !stack.empty() )
+                {
+                    int x = stack.back();
+                    stack.pop_back();
+                    for ( unsigned int i = 0; i < treeAdj[x].size(); i++ )
+                    {
+                        int f = treeAdj[x][i];
+                        int y = ( G[f].getU() == x ) ? G[f].getV() 
+                                                     : G[f].getU();
+                        if ( parentEdge[y] != -2 ) continue;
+                        parentEdge[y] = f;
+                        depth[y] = depth[x] + 1;
+                        stack.push_back( y );
+                    }
+                }
+                rooted = true;
+            }
+            
+            /** Heaviest path edge whose removal keeps a and b within caps **/
+            int out = -1;
+            for ( int x = a, y = b; x != y; )
+            {
+                // Climb from the deeper end of the remaining path
+                if ( depth[x] < depth[y] ) swap( x, y );
+                
+                int f = parentEdge[x];
+                int freedA = ( G[f].getU() == a || G[f].getV() == a );
+                int freedB = ( G[f].getU() == b || G[f].getV() == b );
+                
+                if ( G[f].getW() > G[e].getW() 
+                     && degree[a] + 1 - freedA <= cap[a]
+                     && degree[b] + 1 - freedB <= cap[b]
+                     && ( out < 0 || G[f].getW() > G[out].getW() ) )
+                    out = f;
+                
+                x = ( G[f].getU() == x ) ? G[f].getV() : G[f].getU();
+            }
+            
+            if ( out < 0 ) continue;
+            
+            // Exchange
+            inTree[out] = 0;
+            degree[ G[out].getU() ]--;
+            degree[ G[out].getV() ]--;
+            inTree[e] = 1;
+            degree[a]++;
+            degree[b]++;
+            *find( treeEdges.begin(), treeEdges.end(), out ) = e;
+            improved = true;
+            rooted = false;
+        }
+    }
+    
+    treeEdges.clear();
+    for ( unsigned int i = 0; i < G.size(); i++ )
+    {
+        if ( !inTree[i] ) continue;
+        treeEdges.push_back( i );
+        totalWeight += G[i].getW();
+    }
+    
+    return totalWeight;
+}
+
+/*=============================================================================
+Function: capped_lower_bound
+Description: Returns a lower bound on the lightest capped spanning tree from
+             the Lagrangian relaxation of the caps. Each vertex v carries a
+             price p(v) >= 0 added to its edges; for any prices,
+                 MST(w(u,v) + p(u) + p(v)) - sum of p(v) cap(v)
+             is a lower bound. Prices follow subgradient steps toward the
+             best bound.
+Parameters: G - weighted edges stored as UVW vector set
+            vertexCount - verticy cardinality for G
+            cap - degree cap of each vertex
+            upperBound - weight of a known capped tree, to size the steps
+=============================================================================*/
+double capped_lower_bound( const vector< WeightedEdge > &G, 
+                           unsigned int vertexCount, 
+                           const vector< int > &cap, long long upperBound )
+{
+    const int ITERATIONS = 200;                 // Subgradient steps
+    const int PATIENCE = 20;                    // Steps before halving scale
+    vector< double > price( vertexCount, 0.0 ); // Lagrange multipliers
+    vector< int > order;                        // Edges by priced weight
+    double best = -numeric_limits< double >::infinity();
+    double scale = 2.0;                         // Step size factor
+    int stale = 0;                              // Steps since best improved
+    
+    for ( unsigned int i = 0; i < G.size(); i++ )
+        if ( G[i].getU() != G[i].getV() ) order.push_back( i );
+    
+    for ( int it = 0; it < ITERATIONS; it++ )
+    {
+        vector< int > degree( vertexCount, 0 );
+        DisjointSet sets( vertexCount );
+        double bound = 0;
+        
+        /** Unconstrained MST under the priced weights (Kruskal) **/
+        sort( order.begin(), order.end(), [&]( int a, int b ) 
+              { return G[a].getW() + price[ G[a].getU() ] + price[ G[a].getV() ]
+                     < G[b].getW() + price[ G[b].getU() ] + price[ G[b].getV() ]; 
+              } );
+        
+        for ( unsigned int k = 0; k < order.size(); k++ )
+        {
+            int e = order[k];
+            if ( !sets.join( G[e].getU(), G[e].getV() ) ) continue;
+            
+            bound += G[e].getW() + price[ G[e].getU() ] + price[ G[e].getV() ];
+            degree[ G[e].getU() ]++;
+            degree[ G[e].getV() ]++;
+        }
+        for ( unsigned int v = 0; v < vertexCount; v++ )
+            bound -= price[v] * cap[v];
+        
+        if ( bound > best + 1e-9 )
+        {
+            best = bound;
+            stale = 0;
+        }
+        else if ( ++stale >= PATIENCE )
+        {
+            scale /= 2;
+            stale = 0;
+        }
+        
+        /** Step along the projected subgradient **/
+        vector< double > slope( vertexCount );
+        double norm = 0;
+        
+        for ( unsigned int v = 0; v < vertexCount; v++ )
+        {
+            slope[v] = degree[v] - cap[v];
+            if ( price[v] <= 0 && slope[v] < 0 ) slope[v] = 0;
+            norm += slope[v] * slope[v];
+        }
+        
+        // Every cap met with no slack to exploit: the bound is tight
+        if ( norm == 0 ) break;
+        
+        double step = scale * max( 1e-9, upperBound - bound ) / norm;
+        for ( unsigned int v = 0; v < vertexCount; v++ )
+            price[v] = max( 0.0, price[v] + step * slope[v] );
+    }
+    
+    // Tree weights are integers
+    return ceil( best - 1e-6 );
+}
+
+/*=============================================================================
+Function: canonical_hashing
+Description: Prints the canonical hash of input.txt, or groups the graphs of
+             generated_graphs.txt into isomorphism classes.
+             
+             In the batch, the spanning tree is computed once per class and
+             the result is fanned out to every member. Per-graph results go
+             to canonical_classes.txt as
+                 graph  vertices  class  hash  tree weight (- if none)
+=============================================================================*/
+void canonical_hashing()
+{
+    int source;                     // 1 for input.txt, 2 for the batch
+    
+    do
+    {
+        printf(" 1: Hash input.txt\n");
+        printf(" 2: Classify generated_graphs.txt\n");
+        printf(" > ");
+        cin >> source;
+    } while ( !(source == 1 || source == 2) );
+    cout << endl;
+    
+    if ( source == 1 )
+    {
+        unsigned int vertexCount = 0;   // Stores vertex count from input file
+        vector< WeightedEdge > G;       // Our graph
+        vector< vector< int > > M;      // G as a symmetric matrix
+        vector< int > label;            // Canonical position of each vertex
+        
+        if ( !load_graph( G, vertexCount ) ) return;
+        
+        graph_to_matrix( G, vertexCount, M );
+        GraphHash h = canonical_hash( M, label );
+        
+        cout << "Canonical hash of G:" << endl 
+             << "   " << hash_text( h ) << endl << endl
+             << "Canonical position of each vertex:" << endl << "  ";
+        for ( unsigned int v = 0; v < vertexCount; v++ ) 
+            cout << " " << v << "->" << label[v];
+        cout << endl << endl;
+        return;
+    }
+    
+    /** Batch over generated graphs **/
+    ifstream inputFile;                 // Stores generated graph data
+    ofstream outfile;                   // Stores per-graph results
+    vector< vector< int > > M;          // Current graph
+    map< GraphHash, int > classOf;      // Class index of each hash
+    vector< int > classWeight;          // Tree weight per class, -1 if none
+    map< int, pair< int, int > > tally; // Vertices -> (graphs, classes)
+    int graphs = 0;                     // Graphs read
+    
+    if ( !check_file( inputFile, "generated_graphs.txt" ) ) return;
+    outfile.open( "canonical_classes.txt" );
+    
+    while ( read_generated_graph( inputFile, M ) )
+    {
+        vector< int > label;
+        GraphHash h = canonical_hash( M, label );
+        map< GraphHash, int >::iterator found = classOf.find( h );
+        int c;
+        
+        tally[ M.size() ].first++;
+        
+        if ( found == classOf.end() )
+        {
+            // First member of a class: compute its spanning tree once
+            vector< WeightedEdge > G;
+            vector< int > treeEdges;
+            int weight;
+            
+            matrix_to_graph( M, G );
+            weight = prim_tree( G, M.size(), treeEdges );
+            if ( treeEdges.size() + 1 != M.size() ) weight = -1;
+            
+            c = classWeight.size();
+            classOf[h] = c;
+            classWeight.push_back( weight );
+            tally[ M.size() ].second++;
+        }
+        else c = found->second;
+        
+        outfile << ++graphs << " " << M.size() << " " << c << " " 
+                << hash_text( h ) << " ";
+        if ( classWeight[c] < 0 ) outfile << "-" << endl;
+        else outfile << classWeight[c] << endl;
+    }
+    inputFile.close();
+    outfile.close();
+    
+    cout << "Isomorphism classes in generated_graphs.txt:" << endl;
+    for ( map< int, pair< int, int > >::iterator it = tally.begin(); 
+          it != tally.end(); ++it )
+    {
+        cout << "   " << it->first << " vertices: " << it->second.first 
+             << " graphs, " << it->second.second << " classes" << endl;
+    }
+    cout << endl << "Spanning trees computed: " << classWeight.size() 
+         << " for " << graphs << " graphs" << endl
+         << "Per-graph results written to canonical_classes.txt" 
+         << endl << endl;
+}
+
+/*=============================================================================
+Function: graph_to_matrix
+Description: Expands a UVW edge set into a symmetric weight matrix
+Parameters: G - weighted edges stored as UVW vector set
+            vertexCount - verticy cardinality for G
+            M - receives the matrix, 0 where there is no edge
+=============================================================================*/
+void graph_to_matrix( const vector< WeightedEdge > &G, 
+                      unsigned int vertexCount, vector< vector< int > > &M )
+{
+    M.assign( vertexCount, vector< int >( vertexCount, 0 ) );
+    
+    for ( unsigned int i = 0; i < G.size(); i++ )
+    {
+        M[ G[i].getU() ][ G[i].getV() ] = G[i].getW();
+        M[ G[i].getV() ][ G[i].getU() ] = G[i].getW();
+    }
+}
+
+/*=============================================================================
+Function: matrix_to_graph
+Description: Stores the upper triangle of a weight matrix as UVW vectors,
+             the same way create_graph does
+Parameters: M - symmetric weight matrix
+            G - receives the weighted edges
+=============================================================================*/
+void matrix_to_graph( const vector< vector< int > > &M, 
+                      vector< WeightedEdge > &G )
+{
+    G.clear();
+    
+    for ( unsigned int j = 0; j < M.size(); j++ )
+    {
+        for ( unsigned int i = j; i < M.size(); i++ )
+        {
+            if ( M[j][i] != 0 ) G.push_back( WeightedEdge( i, j, M[j][i] ) );
+        }
+    }
+}
+
+/*=============================================================================
+Function: read_generated_graph
+Description: Reads the next graph written by write_graph: a vertex count,
+             then one row of 0/1 digits per vertex. Returns false at the end
+             of the file.
+Parameters: inputFile - open generated graphs file
+            M - receives the adjacency matrix
+=============================================================================*/
+bool read_generated_graph( ifstream &inputFile, vector< vector< int > > &M )
+{
+    int vertexCount;
+    
+    if ( !( inputFile >> vertexCount ) || vertexCount < 1 ) return false;
+    
+    M.assign( vertexCount, vector< int >( vertexCount, 0 ) );
+    for ( int j = 0; j < vertexCount; j++ )
+    {
+        string row;
+        
+        if ( !( inputFile >> row ) || (int)row.size() != vertexCount ) 
+            return false;
+        for ( int i = 0; i < vertexCount; i++ ) M[j][i] = row[i] - '0';
+    }
+    return true;
+}
+
+/*=============================================================================
+Function: mix_hash
+Description: Folds a value into a running 64-bit hash (splitmix64 finalizer)
+Parameters: h - hash so far
+            x - value to fold in
+=============================================================================*/
+unsigned long long mix_hash( unsigned long long h, unsigned long long x )
+{
+    h ^= x + 0x9e3779b97f4a7c15ULL + ( h << 6 ) + ( h >> 2 );
+    h ^= h >> 30;
+    h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 27;
+    h *= 0x94d049bb133111ebULL;
+    h ^= h >> 31;
+    return h;
+}
+
+/*=============================================================================
+Function: refine_colors
+Description: Refines a vertex coloring until it is equitable: vertices of
+             one color see the same multiset of (neighbour color, weight).
+             Colors are renumbered 0..k-1 by sorted signature, so the result
+             depends only on the graph and the input coloring, never on
+             vertex numbering. Returns a hash of the final signatures.
+Parameters: M - symmetric weight matrix
+            color - vertex colors, refined in place
+=============================================================================*/
+unsigned long long refine_colors( const vector< vector< int > > &M, 
+                                  vector< int > &color )
+{
+    int n = M.size();
+    vector< vector< long long > > signature( n );   // Color, then sorted
+                                                    // (color, weight) pairs
+    vector< int > order( n );                       // Vertices by signature
+    int cells = -1;                                 // Colors before a round
+    unsigned long long trace = 0;                   // Hash of signatures
+    
+    while ( true )
+    {
+        for ( int v = 0; v < n; v++ )
+        {
+            vector< pair< int, int > > seen;
+            
+            for ( int u = 0; u < n; u++ )
+            {
+                if ( u != v && M[v][u] != 0 ) 
+                    seen.push_back( make_pair( color[u], M[v][u] ) );
+            }
+            sort( seen.begin(), seen.end() );
+            
+            signature[v].assign( 1, color[v] );
+            for ( unsigned int i = 0; i < seen.size(); i++ )
+            {
+                signature[v].push_back( seen[i].first );
+                signature[v].push_back( seen[i].second );
+            }
+            order[v] = v;
+        }
+        
+        sort( order.begin(), order.end(), 
+              [&]( int a, int b ) { return signature[a] < signature[b]; } );
+        
+        // Renumber colors by rank of signature
+        int next = 0;
+        trace = n;
+        for ( int i = 0; i < n; i++ )
+        {
+            if ( i > 0 && signature[ order[i] ] != signature[ order[i-1] ] ) 
+                next++;
+            color[ order[i] ] = next;
+            
+            trace = mix_hash( trace, next );
+            for ( unsigned int k = 0; k < signature[ order[i] ].size(); k++ )
+                trace = mix_hash( trace, signature[ order[i] ][k] );
+        }
+        
+        if ( next + 1 == cells ) break;
+        cells = next + 1;
+    }
+    
+    return trace;
+}
+
+/*=============================================================================
+Function: canonical_search
+Description: Depth first search over individualize-and-refine choices. The
+             canonical leaf is the one whose path has the smallest sequence
+             of refinement traces and, among those, the smallest relabeled
+             matrix. Subtrees are cut when their trace is larger than the
+             best path's, when an automorphism fixing the path maps them
+             onto an explored sibling, and when a leaf equal to the best one
+             proves the current branch a copy of an explored one.
+             
+             Returns the depth the search should resume at; a caller deeper
+             than that returns at once.
+Parameters: search - shared search state
+            color - coloring at this node, before refinement
+            path - vertices individualized to reach this node
+=============================================================================*/
+int canonical_search( CanonicalSearch &search, const vector< int > &color,
+                      vector< int > &path )
+{
+    const vector< vector< int > > &M = *search.matrix;
+    int n = M.size();
+    int depth = path.size();
+    vector< int > refined( color );             // Equitable coloring here
+    unsigned long long trace = refine_colors( M, refined );
+    
+    /** Compare against the best path **/
+    if ( depth >= (int)search.bestTrace.size() 
+         || trace < search.bestTrace[depth] )
+    {
+        search.bestTrace.resize( depth );
+        search.bestTrace.push_back( trace );
+        search.haveLeaf = false;
+    }
+    else if ( trace > search.bestTrace[depth] ) return depth;
+    
+    /** Leaf: every vertex has its own color **/
+    if ( *max_element( refined.begin(), refined.end() ) == n - 1 )
+    {
+        vector< int > code( n * n );
+        
+        for ( int u = 0; u < n; u++ )
+            for ( int v = 0; v < n; v++ )
+                code[ refined[u] * n + refined[v] ] = M[u][v];
+        
+        if ( !search.haveLeaf || code < search.bestCode )
+        {
+            search.haveLeaf = true;
+            search.bestCode.swap( code );
+            search.bestLabel = refined;
+            search.bestPath = path;
+            return depth;
+        }
+        
+        if ( code == search.bestCode )
+        {
+            // Map each vertex to the vertex with its label in the best leaf
+            vector< int > inverse( n );
+            vector< int > gamma( n );
+            int diverge = 0;
+            
+            for ( int u = 0; u < n; u++ ) inverse[ search.bestLabel[u] ] = u;
+            for ( int u = 0; u < n; u++ ) gamma[u] = inverse[ refined[u] ];
+            search.automorphisms.push_back( gamma );
+            
+            while ( diverge < depth 
+                    && path[diverge] == search.bestPath[diverge] ) 
+                diverge++;
+            return diverge;
+        }
+        return depth;
+    }
+    
+    /** Branch on the first cell with more than one vertex **/
+    vector< int > size( n, 0 );
+    vector< int > cell;
+    int target = 0;
+    
+    for ( int v = 0; v < n; v++ ) size[ refined[v] ]++;
+    while ( size[target] < 2 ) target++;
+    for ( int v = 0; v < n; v++ ) 
+        if ( refined[v] == target ) cell.push_back( v );
+    
+    vector< int > explored;             // Children searched so far
+    unsigned int known = 0;             // Automorphisms used for orbits
+    DisjointSet orbits( n );            // Orbits of those fixing the path
+    
+    for ( unsigned int i = 0; i < cell.size(); i++ )
+    {
+        int w = cell[i];
+        bool skip = false;
+        
+        // Fold in automorphisms found since the last child
+        for ( ; known < search.automorphisms.size(); known++ )
+        {
+            const vector< int > &gamma = search.automorphisms[known];
+            bool fixes = true;
+            
+            for ( int k = 0; k < depth && fixes; k++ ) 
+                fixes = ( gamma[ path[k] ] == path[k] );
+            if ( !fixes ) continue;
+            
+            for ( int v = 0; v < n; v++ ) orbits.join( v, gamma[v] );
+        }
+        
+        for ( unsigned int k = 0; k < explored.size() && !skip; k++ )
+            skip = ( orbits.find( explored[k] ) == orbits.find( w ) );
+        if ( skip ) continue;
+        
+        // Individualize w: it sorts just before the rest of its cell
+        vector< int > child( n );
+        for ( int v = 0; v < n; v++ ) 
+            child[v] = 2 * refined[v] + ( ( v == w ) ? 0 : 1 );
+        
+        path.push_back( w );
+        int resume = canonical_search( search, child, path );
+        path.pop_back();
+        explored.push_back( w );
+        
+        if ( resume < depth ) return resume;
+    }
+    
+    return depth;
+}
+
+/*=============================================================================
+Function: canonical_labeling
+Description: Computes a canonical labeling: isomorphic weighted graphs get
+             identical matrices once every vertex v is moved to label[v].
+             Self loop weights act as vertex colors.
+Parameters: M - symmetric weight matrix
+            label - receives the canonical position of each vertex
+=============================================================================*/
+void canonical_labeling( const vector< vector< int > > &M, 
+                         vector< int > &label )
+{
+    CanonicalSearch search;             // Search state
+    vector< int > color( M.size() );    // Initial coloring by self loop
+    vector< int > path;                 // Individualized vertices
+    
+    search.matrix = &M;
+    search.haveLeaf = false;
+    for ( unsigned int v = 0; v < M.size(); v++ ) color[v] = M[v][v];
+    
+    canonical_search( search, color, path );
+    label = search.bestLabel;
+}
+
+/*=============================================================================
+Function: canonical_hash
+Description: Returns a 128-bit hash of the canonical form of a graph. Two
+             independently seeded 64-bit hashes of the relabeled matrix are
+             combined, so the value is stable across runs and platforms.
+Parameters: M - symmetric weight matrix
+            label - receives the canonical position of each vertex
+=============================================================================*/
+GraphHash canonical_hash( const vector< vector< int > > &M, 
+                          vector< int > &label )
+{
+    int n = M.size();
+    vector< int > inverse( n );     // Vertex at each canonical position
+    GraphHash h;
+    
+    canonical_labeling( M, label );
+    for ( int v = 0; v < n; v++ ) inverse[ label[v] ] = v;
+    
+    h.high = mix_hash( 0x243f6a8885a308d3ULL, n );
+    h.low = mix_hash( 0x13198a2e03707344ULL, n );
+    for ( int a = 0; a < n; a++ )
+    {
+        for ( int b = a; b < n; b++ )
+        {
+            unsigned long long w = (unsigned int)M[ inverse[a] ][ inverse[b] ];
+            h.high = mix_hash( h.high, w );
+            h.low = mix_hash( h.low, w ^ ( (unsigned long long)b << 32 ) );
+        }
+    }
+    return h;
+}
+
+/*=============================================================================
+Function: hash_text
+Description: Formats a 128-bit hash as 32 hexadecimal digits
+Parameters: h - hash to format
+=============================================================================*/
+string hash_text( const GraphHash &h )
+{
+    char text[33];
+    
+    snprintf( text, sizeof( text ), "%016llx%016llx", h.high, h.low );
+    return string( text );
+}
+
+/*=============================================================================
+Function: clique_and_coloring
+Description: Computes the clique number and chromatic number of input.txt
+             (edge weights ignored), or of every graph in
+             generated_graphs.txt.
+             
+             The batch solves each isomorphism class once, with the classes
+             solved in parallel, and writes per-graph results to
+             graph_invariants.txt as
+                 graph  vertices  clique number  chromatic number  status
+             where status is "exact", or "bound" when the search budget ran
+             out and the chromatic number is only an upper bound.
+=============================================================================*/
+void clique_and_coloring()
+{
+    int source;                     // 1 for input.txt, 2 for the batch
+    
+    do
+    {
+        printf(" 1: Solve input.txt\n");
+        printf(" 2: Solve generated_graphs.txt\n");
+        printf(" > ");
+        cin >> source;
+    } while ( !(source == 1 || source == 2) );
+    cout << endl;
+    
+    if ( source == 1 )
+    {
+        unsigned int vertexCount = 0;   // Stores vertex count from input file
+        vector< WeightedEdge > G;       // Our graph
+        vector< vector< int > > M;      // G as a symmetric matrix
+        vector< int > clique;           // Vertices of a maximum clique
+        vector< int > coloring;         // Color of each vertex
+        
+        if ( !load_graph( G, vertexCount ) ) return;
+        graph_to_matrix( G, vertexCount, M );
+        
+        bool exact;                     // False if the coloring is a bound
+        int omega = max_clique( M, clique );
+        int chi = chromatic_number( M, clique, coloring, exact );
+        
+        cout << "Clique number of G: " << omega << endl << "   vertices";
+        for ( unsigned int i = 0; i < clique.size(); i++ ) 
+            cout << " " << clique[i];
+        cout << endl << endl;
+        if ( exact ) cout << "Chromatic number of G: " << chi << endl << "  ";
+        else cout << "Chromatic number of G: between " << omega << " and " 
+                  << chi << " (search budget reached)" << endl << "  ";
+        for ( unsigned int v = 0; v < vertexCount; v++ ) 
+            cout << " " << v << ":" << coloring[v];
+        cout << endl << endl;
+        return;
+    }
+    
+    /** Group the batch into isomorphism classes **/
+    ifstream inputFile;                     // Stores generated graph data
+    ofstream outfile;                       // Stores per-graph results
+    vector< vector< int > > M;              // Current graph
+    map< GraphHash, int > classOf;          // Class index of each hash
+    vector< vector< vector< int > > > rep;  // First graph of each class
+    vector< int > graphClass;               // Class of each graph
+    
+    if ( !check_file( inputFile, "generated_graphs.txt" ) ) return;
+    
+    while ( read_generated_graph( inputFile, M ) )
+    {
+        vector< int > label;
+        GraphHash h = canonical_hash( M, label );
+        
+        if ( classOf.find( h ) == classOf.end() )
+        {
+            classOf[h] = rep.size();
+            rep.push_back( M );
+        }
+        graphClass.push_back( classOf[h] );
+    }
+    inputFile.close();
+    
+    /** Solve each class once **/
+    vector< int > omega( rep.size() );
+    vector< int > chi( rep.size() );
+    vector< char > exact( rep.size() );     // False if chi is a bound
+    
+    #pragma omp parallel for schedule(dynamic)
+    for ( int c = 0; c < (int)rep.size(); c++ )
+    {
+        vector< int > clique;
+        vector< int > coloring;
+        bool solved;
+        
+        omega[c] = max_clique( rep[c], clique );
+        chi[c] = chromatic_number( rep[c], clique, coloring, solved );
+        exact[c] = solved;
+    }
+    
+    /** Fan results out **/
+    map< pair< int, pair< int, int > >, int > tally; // (n, (omega, chi))
+    int bounded = 0;                        // Graphs with only a bound on chi
+    
+    outfile.open( "graph_invariants.txt" );
+    for ( unsigned int i = 0; i < graphClass.size(); i++ )
+    {
+        int c = graphClass[i];
+        
+        outfile << i + 1 << " " << rep[c].size() << " " << omega[c] << " " 
+                << chi[c] << " " << ( exact[c] ? "exact" : "bound" ) << endl;
+        if ( !exact[c] ) bounded++;
+        tally[ make_pair( (int)rep[c].size(), 
+                          make_pair( omega[c], chi[c] ) ) ]++;
+    }
+    outfile.close();
+    
+    cout << "Graphs by clique number and chromatic number:" << endl;
+    for ( map< pair< int, pair< int, int > >, int >::iterator it = 
+              tally.begin(); it != tally.end(); ++it )
+    {
+        cout << "   " << it->first.first << " vertices, clique " 
+             << it->first.second.first << ", chromatic " 
+             << it->first.second.second << ": " << it->second << endl;
+    }
+    if ( bounded > 0 )
+        cout << endl << bounded << " graphs have only an upper bound on the "
+             << "chromatic number (search budget reached)" << endl;
+    cout << endl << "Solved " << rep.size() << " classes for " 
+         << graphClass.size() << " graphs" << endl
+         << "Per-graph results written to graph_invariants.txt" 
+         << endl << endl;
+}
+
+/*=============================================================================
+Function: build_bitgraph
+Description: Packs the adjacency of a matrix into bit rows, renumbering the
+             vertices so that bit i stands for vertex order[i]
+Parameters: M - symmetric weight matrix, nonzero off the diagonal for edges
+            order - vertex of M placed at each position
+            g - receives the packed graph
+=============================================================================*/
+void build_bitgraph( const vector< vector< int > > &M, 
+                     const vector< int > &order, BitGraph &g )
+{
+    g.n = order.size();
+    g.words = ( g.n + 63 ) / 64;
+    g.bits.assign( (size_t)g.n * g.words, 0 );
+    
+    for ( int a = 0; a < g.n; a++ )
+    {
+        for ( int b = 0; b < g.n; b++ )
+        {
+            if ( a != b && M[ order[a] ][ order[b] ] != 0 )
+                g.bits[ (size_t)a * g.words + b / 64 ] |= 1ULL << ( b % 64 );
+        }
+    }
+}
+
+/*=============================================================================
+Function: color_sort
+Description: Greedily colors the vertices of P, one color class at a time,
+             and lists them by color. Any clique inside the first i listed
+             vertices has at most colors[i-1] vertices.
+Parameters: g - packed graph
+            P - candidate vertices
+            order - receives the vertices of P in color order
+            colors - receives the color of each listed vertex (from 1)
+=============================================================================*/
+void color_sort( const BitGraph &g, vector< unsigned long long > P,
+                 vector< int > &order, vector< int > &colors )
+{
+    vector< unsigned long long > Q( g.words );  // Vertices free for a color
+    int color = 0;                              // Current color
+    
+    order.clear();
+    colors.clear();
+    
+    for ( bool left = true; left; )
+    {
+        color++;
+        Q = P;
+        left = false;
+        
+        for ( int w = 0; w < g.words; w++ )
+        {
+            while ( Q[w] )
+            {
+                int v = w * 64 + __builtin_ctzll( Q[w] );
+                const unsigned long long *N = g.row( v );
+                
+                order.push_back( v );
+                colors.push_back( color );
+                P[w] &= ~( 1ULL << ( v % 64 ) );
+                
+                // Neighbours of v cannot share its color
+                Q[w] &= ~( 1ULL << ( v % 64 ) );
+                for ( int k = w; k < g.words; k++ ) Q[k] &= ~N[k];
+            }
+        }
+        
+        for ( int w = 0; w < g.words; w++ ) if ( P[w] ) left = true;
+    }
+}
+
+/*=============================================================================
+Function: clique_expand
+Description: Branch and bound step of the maximum clique search (MCQ/BBMC
+             style). Candidates are tried from the highest color down; a
+             branch stops once the current clique plus its color bound
+             cannot beat the best clique.
+Parameters: g - packed graph
+            current - clique being grown
+            P - vertices adjacent to all of current
+            shared - best clique found by any branch
+=============================================================================*/
+void clique_expand( const BitGraph &g, vector< int > &current,
+                    vector< unsigned long long > P, CliqueSearch &shared )
+{
+    vector< int > order;                // Candidates in color order
+    vector< int > colors;               // Their color bounds
+    vector< unsigned long long > next( g.words );
+    
+    color_sort( g, P, order, colors );
+    
+    if ( order.empty() )
+    {
+        // Writers are serialized by the critical section, but the bound
+        // is read outside it, so the store itself must be atomic
+        #pragma omp critical (clique_best)
+        {
+            if ( (int)current.size() > shared.best )
+            {
+                #pragma omp atomic write
+                shared.best = current.size();
+                shared.clique = current;
+            }
+        }
+        return;
+    }
+    
+    for ( int i = order.size() - 1; i >= 0; i-- )
+    {
+        int best;
+        
+        #pragma omp atomic read
+        best = shared.best;
+        
+        if ( (int)current.size() + colors[i] <= best ) return;
+        
+        int v = order[i];
+        const unsigned long long *N = g.row( v );
+        
+        for ( int w = 0; w < g.words; w++ ) next[w] = P[w] & N[w];
+        
+        current.push_back( v );
+        clique_expand( g, current, next, shared );
+        current.pop_back();
+        
+        P[ v / 64 ] &= ~( 1ULL << ( v % 64 ) );
+    }
+}
+
+/*=============================================================================
+Function: max_clique
+Description: Returns the clique number of a graph. Vertices are numbered by
+             decreasing degree, and the branches below the root run in
+             parallel with dynamic scheduling, sharing the best clique.
+Parameters: M - symmetric weight matrix, nonzero off the diagonal for edges
+            clique - receives the vertices of a maximum clique
+=============================================================================*/
+int max_clique( const vector< vector< int > > &M, vector< int > &clique )
+{
+    int n = M.size();
+    vector< int > byDegree( n );        // Vertex of M at each position
+    vector< int > degree( n, 0 );
+    BitGraph g;                         // Packed graph in that order
+    CliqueSearch shared;                // Best clique so far
+    vector< int > order;                // Root candidates in color order
+    vector< int > colors;               // Their color bounds
+    
+    clique.clear();
+    if ( n == 0 ) return 0;
+    
+    for ( int v = 0; v < n; v++ )
+    {
+        byDegree[v] = v;
+        for ( int u = 0; u < n; u++ ) 
+            if ( u != v && M[v][u] != 0 ) degree[v]++;
+    }
+    stable_sort( byDegree.begin(), byDegree.end(), 
+                 [&]( int a, int b ) { return degree[a] > degree[b]; } );
+    build_bitgraph( M, byDegree, g );
+    
+    shared.best = 0;
+    vector< unsigned long long > all( g.words, 0 );
+    for ( int v = 0; v < n; v++ ) all[ v / 64 ] |= 1ULL << ( v % 64 );
+    color_sort( g, all, order, colors );
+    
+    /** Root branches: vertex order[i] with candidates order[0..i-1] **/
+    #pragma omp parallel for schedule(dynamic, 1)
+    for ( int i = n - 1; i >= 0; i-- )
+    {
+        int best;
+        
+        #pragma omp atomic read
+        best = shared.best;
+        
+        if ( colors[i] <= best ) continue;
+        
+        int v = order[i];
+        const unsigned long long *N = g.row( v );
+        vector< unsigned long long > P( g.words, 0 );
+        vector< int > current( 1, v );
+        
+        for ( int k = 0; k < i; k++ ) 
+            P[ order[k] / 64 ] |= 1ULL << ( order[k] % 64 );
+        for ( int w = 0; w < g.words; w++ ) P[w] &= N[w];
+        
+        clique_expand( g, current, P, shared );
+    }
+    
+    for ( unsigned int i = 0; i < shared.clique.size(); i++ )
+        clique.push_back( byDegree[ shared.clique[i] ] );
+    sort( clique.begin(), clique.end() );
+    
+    return shared.best;
+}
+
+/*=============================================================================
+Function: assign_color
+Description: Colors a vertex and updates its neighbours' saturation
+Parameters: search - coloring search state
+            v - vertex to color
+            c - color
+=============================================================================*/
+void assign_color( ColoringSearch &search, int v, int c )
+{
+    search.color[v] = c;
+    
+    for ( unsigned int i = 0; i < search.adj[v].size(); i++ )
+    {
+        int u = search.adj[v][i];
+        if ( search.seen[u][c]++ == 0 ) search.saturation[u]++;
+    }
+}
+
+/*=============================================================================
+Function: clear_color
+Description: Undoes assign_color
+Parameters: search - coloring search state
+            v - vertex to uncolor
+=============================================================================*/
+void clear_color( ColoringSearch &search, int v )
+{
+    int c = search.color[v];
+    
+    for ( unsigned int i = 0; i < search.adj[v].size(); i++ )
+    {
+        int u = search.adj[v][i];
+        if ( --search.seen[u][c] == 0 ) search.saturation[u]--;
+    }
+    search.color[v] = -1;
+}
+
+/*=============================================================================
+Function: dsatur_search
+Description: DSATUR branch and bound: colors the uncolored vertex with the
+             most distinct neighbour colors (ties: most neighbours) with each
+             feasible old color, or one new color, pruning branches that
+             cannot beat the best coloring. The first dive is plain DSATUR.
+Parameters: search - coloring search state
+            colored - vertices colored so far
+            used - colors used so far
+=============================================================================*/
+void dsatur_search( ColoringSearch &search, int colored, int used )
+{
+    int n = search.adj.size();
+    
+    if ( search.best == search.lower ) return;
+    if ( ++search.nodes > search.nodeLimit ) return;
+    
+    if ( colored == n )
+    {
+        if ( used < search.best )
+        {
+            search.best = used;
+            search.bestColor = search.color;
+        }
+        return;
+    }
+    
+    /** Most saturated uncolored vertex **/
+    int v = -1;
+    for ( int u = 0; u < n; u++ )
+    {
+        if ( search.color[u] >= 0 ) continue;
+        if ( v < 0 || search.saturation[u] > search.saturation[v] 
+             || ( search.saturation[u] == search.saturation[v] 
+                  && search.adj[u].size() > search.adj[v].size() ) )
+            v = u;
+    }
+    
+    for ( int c = 0; c <= used && c < search.best - 1; c++ )
+    {
+        if ( search.seen[v][c] > 0 ) continue;
+        
+        assign_color( search, v, c );
+        dsatur_search( search, colored + 1, max( used, c + 1 ) );
+        clear_color( search, v );
+        
+        if ( search.best == search.lower ) return;
+    }
+}
+
+/*=============================================================================
+Function: chromatic_number
+Description: Returns the chromatic number of a graph with exact DSATUR
+             branch and bound. A maximum clique is colored first; its size
+             is the lower bound that ends the search early. Large hard
+             graphs may exhaust the node budget, in which case the best
+             coloring found is returned as an upper bound.
+Parameters: M - symmetric weight matrix, nonzero off the diagonal for edges
+            clique - vertices of a maximum clique of M
+            coloring - receives the best color found for each vertex
+            exact - set to false if the node budget ran out
+=============================================================================*/
+int chromatic_number( const vector< vector< int > > &M, 
+                      const vector< int > &clique, vector< int > &coloring,
+                      bool &exact )
+{
+    int n = M.size();
+    ColoringSearch search;              // Search state
+    
+    coloring.clear();
+    if ( n == 0 ) return 0;
+    
+    search.adj.assign( n, vector< int >() );
+    for ( int v = 0; v < n; v++ )
+        for ( int u = 0; u < n; u++ )
+            if ( u != v && M[v][u] != 0 ) search.adj[v].push_back( u );
+    
+    search.color.assign( n, -1 );
+    search.seen.assign( n, vector< int >( n + 1, 0 ) );
+    search.saturation.assign( n, 0 );
+    search.best = n + 1;
+    search.lower = max( 1, (int)clique.size() );
+    search.nodes = 0;
+    search.nodeLimit = 1000000;
+    
+    for ( unsigned int i = 0; i < clique.size(); i++ ) 
+        assign_color( search, clique[i], i );
+    
+    dsatur_search( search, clique.size(), clique.size() );
+    
+    coloring = search.bestColor;
+    exact = ( search.nodes <= search.nodeLimit );
+    return search.best;
+}
+
+/*=============================================================================
+Function: directed_arborescence
+Description: Reads input.txt as a directed graph and calculates the minimum
+             spanning arborescence rooted at a chosen vertex: the cheapest
+             set of arcs giving every vertex one path from the root
+=============================================================================*/
+void directed_arborescence()
+{
+    unsigned int vertexCount = 0;   // Stores vertex count from input file
+    int root;                       // Vertex every path starts from
+    long long totalWeight;          // Tracks weight of the arborescence
+    ifstream inputFile;             // Stores input file data to read from
+    vector< WeightedEdge > G;       // Our directed graph
+    vector< WeightedEdge > T;       // Our arborescence
+    vector< int > inArc;            // Arc entering each vertex
+    
+    if ( !check_file( inputFile ) ) return;
+    create_digraph( inputFile, G, vertexCount );
+    inputFile.close();
+    
+    if ( vertexCount < 1 )
+    {
+        cout << "input.txt must describe a graph with at least one vertex." 
+             << endl << endl;
+        return;
+    }
+    
+    do
+    {
+        printf(" Root vertex?\n");
+        printf(" > ");
+        cin >> root;
+    } while ( !(root >= 0 && root < (int)vertexCount) );
+    cout << endl;
+    
+    if ( !min_arborescence( G, vertexCount, root, inArc, totalWeight ) )
+    {
+        cout << "Some vertex cannot be reached from vertex " << root << "." 
+             << endl << endl;
+        return;
+    }
+    
+    for ( unsigned int v = 0; v < vertexCount; v++ )
+        if ( inArc[v] >= 0 ) T.push_back( G[ inArc[v] ] );
+    
+    /** Print T **/
+    cout << "The minimum spanning arborescence T rooted at " << root 
+         << " (arcs as <tail, head>):" << endl;
+    print_graph(T);
+    
+    cout << "Total weight of T: " << endl 
+         << "   " << totalWeight << endl << endl;
+}
+
+/*=============================================================================
+Function: push_arc_offset
+Description: Applies a node's pending offset to its key and hands it down to
+             its children
+Parameters: heap - node pool
+            x - node
+=============================================================================*/
+void push_arc_offset( vector< ArcHeapNode > &heap, int x )
+{
+    heap[x].key += heap[x].delta;
+    if ( heap[x].left >= 0 ) heap[ heap[x].left ].delta += heap[x].delta;
+    if ( heap[x].right >= 0 ) heap[ heap[x].right ].delta += heap[x].delta;
+    heap[x].delta = 0;
+}
+
+/*=============================================================================
+Function: merge_arc_heaps
+Description: Melds two skew heaps and returns the new root
+Parameters: heap - node pool
+            a, b - roots, -1 for an empty heap
+=============================================================================*/
+int merge_arc_heaps( vector< ArcHeapNode > &heap, int a, int b )
+{
+    if ( a < 0 ) return b;
+    if ( b < 0 ) return a;
+    
+    push_arc_offset( heap, a );
+    push_arc_offset( heap, b );
+    if ( heap[a].key > heap[b].key ) swap( a, b );
+    
+    int merged = merge_arc_heaps( heap, b, heap[a].right );
+    heap[a].right = heap[a].left;
+    heap[a].left = merged;
+    
+    return a;
+}
+
+/*=============================================================================
+Function: min_arborescence
+Description: Edmonds' algorithm with mergeable heaps (Tarjan's formulation,
+             O(|E| log |V|)). Every vertex keeps a skew heap of its incoming
+             arcs. Walking from each vertex, the cheapest incoming arc is
+             taken and the rest of its heap is lowered by that weight; a
+             walk that closes a cycle contracts it by melding the heaps.
+             Contractions are recorded with a rollback union-find so the
+             chosen arcs can be unwound into a real arborescence.
+             Returns false if a vertex is unreachable from the root.
+Parameters: G - weighted arcs stored as UVW vector set (u tail, v head)
+            vertexCount - verticy cardinality for G
+            root - root of the arborescence
+            inArc - receives the arc entering each vertex (-1 at the root)
+            totalWeight - receives the total weight of the arborescence
+=============================================================================*/
+bool min_arborescence( const vector< WeightedEdge > &G, 
+                       unsigned int vertexCount, int root,
+                       vector< int > &inArc, long long &totalWeight )
+{
+    int n = vertexCount;
+    RollbackSet sets( n );                  // Contracted cycles
+    vector< ArcHeapNode > heap;             // Node pool of all skew heaps
+    vector< int > top( n, -1 );             // Heap of arcs into each vertex
+    vector< int > seen( n, -1 );            // Walk that reached each vertex
+    vector< int > path( n );                // Vertices of the current walk
+    vector< int > chosen( n );              // Arc taken into each of them
+    vector< pair< int, int > > cycles;      // (component, union-find time)
+    vector< vector< int > > cycleArcs;      // Arcs of each contracted cycle
+    
+    inArc.assign( n, -1 );
+    totalWeight = 0;
+    
+    for ( unsigned int i = 0; i < G.size(); i++ )
+    {
+        ArcHeapNode node;
+        node.arc = i;
+        node.key = G[i].getW();
+        node.delta = 0;
+        node.left = node.right = -1;
+        heap.push_back( node );
+        top[ G[i].getV() ] = merge_arc_heaps( heap, top[ G[i].getV() ], i );
+    }
+    
+    seen[root] = root;
+    for ( int s = 0; s < n; s++ )
+    {
+        int u = s;          // Current component of the walk
+        int length = 0;     // Vertices on the walk
+        
+        while ( seen[u] < 0 )
+        {
+            if ( top[u] < 0 ) return false;
+            
+            /** Take the cheapest arc into u and lower the rest **/
+            int x = top[u];
+            push_arc_offset( heap, x );
+            long long w = heap[x].key;
+            int arc = heap[x].arc;
+            
+            heap[x].delta -= w;
+            push_arc_offset( heap, x );
+            top[u] = merge_arc_heaps( heap, heap[x].left, heap[x].right );
+            
+            chosen[length] = arc;
+            path[length++] = u;
+            seen[u] = s;
+            totalWeight += w;
+            u = sets.find( G[arc].getU() );
+            
+            /** The walk closed a cycle: contract it **/
+            if ( seen[u] == s )
+            {
+                int end = length;
+                int time = sets.time();
+                int cycle = -1;
+                int v;
+                
+                do
+                {
+                    v = path[--length];
+                    cycle = merge_arc_heaps( heap, cycle, top[v] );
+                } while ( sets.join( u, v ) );
+                
+                u = sets.find( u );
+                top[u] = cycle;
+                seen[u] = -1;
+                cycles.push_back( make_pair( u, time ) );
+                cycleArcs.push_back( vector< int >( chosen.begin() + length, 
+                                                    chosen.begin() + end ) );
+            }
+        }
+        
+        for ( int i = 0; i < length; i++ )
+            inArc[ sets.find( G[ chosen[i] ].getV() ) ] = chosen[i];
+    }
+    
+    /** Expand the cycles, newest first **/
+    for ( int c = cycles.size() - 1; c >= 0; c-- )
+    {
+        int entering = inArc[ cycles[c].first ];
+        
+        sets.rollback( cycles[c].second );
+        for ( unsigned int i = 0; i < cycleArcs[c].size(); i++ )
+            inArc[ sets.find( G[ cycleArcs[c][i] ].getV() ) ] = cycleArcs[c][i];
+        inArc[ sets.find( G[entering].getV() ) ] = entering;
+    }
+    
+    return true;
+}
+
+/*=============================================================================
+Function: approximate_tree_weight
+Description: Estimates the weight of the minimum spanning tree of input.txt
+             without building it (Chazelle-Rubinfeld-Trevisan). For integer
+             weights in 1..W and c(t) the component count of the subgraph
+             of edges no heavier than t,
+                 weight(T) = sum over t = 0..W-1 of ( c(t) - 1 ).
+             c(t) is sampled on a geometric grid of thresholds: c(t) is n
+             times the mean of 1/|component| over random start vertices,
+             found by breadth first searches cut off at a size limit.
+             
+             Half the error budget goes to the grid, a quarter to the search
+             limit and a quarter to sampling; the printed interval holds with
+             the chosen confidence. The sample size uses Bernstein's bound
+             with the variance of 1/|component| at most its mean c(t)/n, so
+             the sampling error scales with sqrt(n weight(T)) rather than
+             with n W. When the sample would not be smaller than the vertex
+             set, the exact weight is computed with kkt_tree instead.
+             G must be connected, with positive weights no heavier than W.
+             Each threshold has its own random stream seeded by
+             (seed, threshold).
+=============================================================================*/
+void approximate_tree_weight()
+{
+    unsigned int vertexCount = 0;       // Stores vertex count from input file
+    double epsilon;                     // Relative error allowed
+    double delta;                       // Chance the interval may miss
+    int maxWeight;                      // Largest edge weight W
+    unsigned int seed;                  // Base seed of the random streams
+    vector< WeightedEdge > G;           // Our graph
+    vector< vector< int > > adj;        // Incident edges of each vertex
+    vector< int > threshold;            // Grid of thresholds, 0 to W
+    long long touched = 0;              // Edges looked at by the searches
+    int heaviest = 0;                   // Largest edge weight in G
+    
+    if ( !load_graph( G, vertexCount ) ) return;
+    build_adjacency( G, vertexCount, adj );
+    
+    // The formula counts components, so a forest would be off by (k-1) W
+    if ( !is_connected( G, adj ) )
+    {
+        cout << "G is disconnected and has no spanning tree." 
+             << endl << endl;
+        return;
+    }
+    
+    for ( unsigned int i = 0; i < G.size(); i++ )
+    {
+        if ( G[i].getW() < 1 )
+        {
+            cout << "Edge weights must be positive." << endl << endl;
+            return;
+        }
+        heaviest = max( heaviest, G[i].getW() );
+    }
+    touched += G.size();
+    
+    do
+    {
+        printf(" Relative error (e.g. 0.1)?\n");
+        printf(" > ");
+        cin >> epsilon;
+    } while ( !(epsilon > 0 && epsilon < 1) );
+    
+    do
+    {
+        printf(" Chance of missing the interval (e.g. 0.05)?\n");
+        printf(" > ");
+        cin >> delta;
+    } while ( !(delta > 0 && delta < 1) );
+    
+    do
+    {
+        printf(" Largest edge weight W (0 to scan G for it)?\n");
+        printf(" > ");
+        cin >> maxWeight;
+    } while ( !(maxWeight >= 0) );
+    
+    printf(" Random seed?\n");
+    printf(" > ");
+    cin >> seed;
+    cout << endl;
+    
+    // A W below the heaviest edge would cut the threshold grid short
+    if ( maxWeight == 0 ) maxWeight = heaviest;
+    if ( maxWeight < heaviest )
+    {
+        cout << "W must be at least the largest edge weight, " << heaviest 
+             << "." << endl << endl;
+        return;
+    }
+    
+    /** Geometric grid with ratio 1 + epsilon/2 **/
+    threshold.push_back( 0 );
+    while ( threshold.back() < maxWeight )
+    {
+        int t = threshold.back();
+        int next = max( t + 1, (int)( t * ( 1 + epsilon / 2 ) ) );
+        
+        threshold.push_back( min( next, maxWeight ) );
+    }
+    
+    /** Sample size and search limit for the other half of the budget **/
+    int levels = threshold.size() - 2;  // Sampled thresholds (not 0 or W)
+    double n = vertexCount;
+    double log2L = log( 2.0 * max( levels, 1 ) / delta );
+    double target = epsilon / 4 * ( n - 1 );
+                                        // Sampling error allowed at the
+                                        // lightest possible tree, n - 1
+    // Summed over the grid, the Bernstein deviations stay below
+    //     sqrt( spread / s ) + bias / s
+    // for s start vertices, taking weight(T) = n - 1 as the worst case
+    double spread = 2 * n * log2L * maxWeight * ( n - 1 + maxWeight );
+    double bias = 2 * n * log2L * maxWeight / 3;
+    double root = 2 * target / ( sqrt( spread ) 
+                                 + sqrt( spread + 4 * bias * target ) );
+    double samples = ceil( 1 / ( root * root ) );
+    
+    if ( samples >= n )
+    {
+        // Sampling would search every vertex anyway
+        vector< int > treeEdges;
+        int totalWeight = kkt_tree( G, vertexCount, treeEdges );
+        
+        cout << "Sampling would need " << samples << " start vertices per "
+             << "threshold, not fewer than |V| = " << vertexCount << endl
+             << "Edges touched: " << touched + G.size() << " (exact "
+             << "minimum spanning tree)" << endl << endl;
+        cout << "Exact weight of T: " << endl 
+             << "   " << totalWeight << endl << endl;
+        return;
+    }
+    
+    int limit = (int)ceil( 4 * n * maxWeight / ( epsilon * ( n - 1 ) ) );
+    int sampleCount = (int)samples;
+    vector< double > count( threshold.size(), 1 );
+                                        // Component count at each threshold
+    
+    count[0] = n;
+    
+    #pragma omp parallel
+    {
+        vector< int > mark( vertexCount, -1 );  // Stamp of the last search
+        vector< int > queue;                    // Search queue
+        int stamp = 0;                          // Current search
+        
+        #pragma omp for schedule(dynamic) reduction(+:touched)
+        for ( int k = 1; k <= levels; k++ )
+        {
+            seed_seq stream{ seed, (unsigned int)k };
+            mt19937_64 rng( stream );
+            uniform_int_distribution< int > pick( 0, vertexCount - 1 );
+            double sum = 0;
+            
+            for ( int j = 0; j < sampleCount; j++ )
+            {
+                sum += component_share( G, adj, pick( rng ), threshold[k], 
+                                        limit, mark, stamp++, queue, 
+                                        touched );
+            }
+            count[k] = n * sum / sampleCount;
+        }
+    }
+    
+    /** Add up the grid **/
+    double estimate = 0;
+    for ( unsigned int k = 0; k + 1 < threshold.size(); k++ )
+    {
+        estimate += ( threshold[k+1] - threshold[k] ) 
+                    * max( count[k] - 1, 0.0 );
+    }
+    
+    cout << "Thresholds: " << threshold.size() << ", start vertices per "
+         << "threshold: " << sampleCount << ", search limit: " << limit 
+         << endl;
+    cout << "Edges touched: " << touched << " (" 
+         << 100.0 * touched / max( (double)G.size(), 1.0 ) 
+         << "% of |E| = " << G.size() << ")" << endl << endl;
+    
+    // The grid sum lies within a factor 1 +- epsilon/2 of the estimate,
+    // and weight(T) within a factor 1 + epsilon/2 below the grid sum
+    cout << "Estimated weight of T: " << endl 
+         << "   " << estimate << endl;
+    cout << "With probability at least " << 1 - delta << ", weight(T) lies in:"
+         << endl << "   [" << max( estimate / ( 1 + epsilon / 2 ) 
+                                            / ( 1 + epsilon / 2 ), n - 1 )
+         << ", " << estimate / ( 1 - epsilon / 2 ) << "]" << endl << endl;
+}
+
+/*=============================================================================
+Function: component_share
+Description: Breadth first search from start over the edges no heavier than
+             threshold. Returns 1/size of the component reached, or 0 if the
+             component has more than limit vertices (the search stops there).
+Parameters: G - weighted edges stored as UVW vector set
+            adj - incident edge indices of each vertex
+            start - first vertex of the search
+            threshold - heaviest edge weight that may be crossed
+            limit - most vertices to visit
+            mark - per vertex, the stamp of the last search to reach it
+            stamp - stamp of this search
+            queue - scratch space for the search queue
+            touched - counts the edges looked at
+=============================================================================*/
+double component_share( const vector< WeightedEdge > &G, 
+                        const vector< vector< int > > &adj, int start,
+                        int threshold, int limit, vector< int > &mark,
+                        int stamp, vector< int > &queue, 
+                        long long &touched )
+{
+    queue.clear();
+    queue.push_back( start );
+    mark[start] = stamp;
+    
+    for ( unsigned int head = 0; head < queue.size(); head++ )
+    {
+        int x = queue[head];
+        
+        for ( unsigned int i = 0; i < adj[x].size(); i++ )
+        {
+            const WeightedEdge &e = G[ adj[x][i] ];
+            int y = ( e.getU() == x ) ? e.getV() : e.getU();
+            
+            touched++;
+            if ( e.getW() > threshold || mark[y] == stamp ) continue;
+            
+            if ( (int)queue.size() == limit ) return 0;
+            
+            mark[y] = stamp;
+            queue.push_back( y );
+        }
+    }
+    
+    return 1.0 / queue.size();
+}
+
+/*=============================================================================
+Function: tree_sensitivity
+Description: Finds the minimum spanning forest T of input.txt and prints,
+             for every edge, how far its weight may move with T staying a
+             minimum spanning forest: the largest increase for edges of T
+             and the largest decrease for the other edges
+=============================================================================*/
+void tree_sensitivity()
+{
+    unsigned int vertexCount = 0;       // Stores vertex count from input file
+    int totalWeight;                    // Tracks weight of T
+    vector< WeightedEdge > G;           // Our graph
+    vector< int > treeEdges;            // Indices in G of the edges of T
+    vector< char > inT;                 // Marks edges of T
+    vector< long long > tolerance;      // Allowed move of each edge, -1 for
+                                        // no limit
+    
+    if ( !load_graph( G, vertexCount ) ) return;
+    
+    totalWeight = kkt_tree( G, vertexCount, treeEdges );
+    tree_tolerances( G, vertexCount, treeEdges, tolerance );
+    
+    inT.assign( G.size(), 0 );
+    for ( unsigned int i = 0; i < treeEdges.size(); i++ )
+        inT[ treeEdges[i] ] = 1;
+    
+    cout << endl << "Weight of the minimum spanning forest T: " << totalWeight
+         << endl << endl << "Tolerance of each edge of G:" << endl;
+    for ( unsigned int i = 0; i < G.size(); i++ )
+    {
+        if ( G[i].getU() == G[i].getV() ) continue;
+        
+        cout << "   Edge " << i << ": ";
+        G[i].print_edge();
+        if ( !inT[i] )
+            cout << " not in T, may fall by " << tolerance[i];
+        else if ( tolerance[i] < 0 )
+            cout << " in T, bridge, may rise without limit";
+        else
+            cout << " in T, may rise by " << tolerance[i];
+        cout << endl;
+    }
+    cout << endl;
+}
+
+/*=============================================================================
+Function: tree_tolerances
+Description: Sensitivity analysis of a minimum spanning forest in
+             O(|E| log |V|) time. A non-tree edge may fall until it ties the
+             heaviest edge on the tree path between its ends (path maximum
+             queries). A tree edge may rise until it ties the lightest
+             non-tree edge whose tree path covers it; non-tree edges are
+             taken lightest first and each one marks the still uncovered
+             tree edges on its path, skipping covered stretches with a
+             union-find, so every tree edge is marked once.
+Parameters: G - weighted edges stored as UVW vector set
+            vertexCount - verticy cardinality for G
+            treeEdges - indices in G of the edges of a minimum spanning
+                        forest
+            tolerance - receives the allowed move of each edge of G, or -1
+                        for tree edges no other edge covers (self loops
+                        get 0)
+=============================================================================*/
+void tree_tolerances( const vector< WeightedEdge > &G, 
+                      unsigned int vertexCount, 
+                      const vector< int > &treeEdges,
+                      vector< long long > &tolerance )
+{
+    vector< vector< int > > adj;                // Tree edges at each vertex
+    vector< int > parent( vertexCount, -1 );    // Parent vertex in T
+    vector< int > parentEdge( vertexCount, -1 );// Edge to the parent
+    vector< int > depth( vertexCount, -1 );     // Depth below the root
+    vector< int > jump( vertexCount );          // Covered stretches
+    vector< int > order;                        // Vertices breadth first
+    vector< char > inT( G.size(), 0 );          // Marks edges of T
+    vector< pair< int, int > > others;          // (weight, index) of the
+                                                // non-tree edges
+    
+    tolerance.assign( G.size(), 0 );
+    
+    adj.assign( vertexCount, vector< int >() );
+    for ( unsigned int i = 0; i < treeEdges.size(); i++ )
+    {
+        int e = treeEdges[i];
+        
+        inT[e] = 1;
+        tolerance[e] = -1;
+        adj[ G[e].getU() ].push_back( e );
+        adj[ G[e].getV() ].push_back( e );
+    }
+    
+    /** Root every tree of T **/
+    for ( unsigned int r = 0; r < vertexCount; r++ )
+    {
+        if ( depth[r] != -1 ) continue;
+        
+        depth[r] = 0;
+        order.push_back( r );
+        for ( unsigned int head = order.size() - 1; head < order.size(); 
+              head++ )
+        {
+            int x = order[head];
+            
+            for ( unsigned int i = 0; i < adj[x].size(); i++ )
+            {
+                int e = adj[x][i];
+                int y = ( G[e].getU() == x ) ? G[e].getV() : G[e].getU();
+                
+                if ( depth[y] != -1 ) continue;
+                
+                depth[y] = depth[x] + 1;
+                parent[y] = x;
+                parentEdge[y] = e;
+                order.push_back( y );
+            }
+        }
+    }
+    
+    /** Non-tree edges: distance down to the path maximum **/
+    {
+        PathMaxTree paths( G, vertexCount, treeEdges, vector< char >() );
+        
+        for ( unsigned int i = 0; i < G.size(); i++ )
+        {
+            if ( inT[i] || G[i].getU() == G[i].getV() ) continue;
+            
+            int m = paths.query( G[i].getU(), G[i].getV() );
+            
+            tolerance[i] = (long long)G[i].getW() - G[m].getW();
+            others.push_back( make_pair( G[i].getW(), i ) );
+        }
+    }
+    
+    /** Tree edges: distance up to the lightest covering edge **/
+    sort( others.begin(), others.end() );
+    for ( unsigned int x = 0; x < vertexCount; x++ ) jump[x] = x;
+    
+    for ( unsigned int i = 0; i < others.size(); i++ )
+    {
+        const WeightedEdge &e = G[ others[i].second ];
+        int a = covered_top( jump, e.getU() );
+        int b = covered_top( jump, e.getV() );
+        
+        while ( a != b )
+        {
+            if ( depth[a] < depth[b] ) swap( a, b );
+            
+            // Edge from a to its parent is covered first by e
+            tolerance[ parentEdge[a] ] = (long long)e.getW() 
+                                         - G[ parentEdge[a] ].getW();
+            jump[a] = parent[a];
+            a = covered_top( jump, a );
+        }
+    }
+}
+
+/*=============================================================================
+Function: covered_top
+Description: Returns the highest vertex reachable from x over tree edges
+             already covered, halving the jump chain on the way
+Parameters: jump - per vertex, itself or a vertex above it on covered edges
+            x - starting vertex
+=============================================================================*/
+int covered_top( vector< int > &jump, int x )
+{
+    while ( jump[x] != x ) x = jump[x] = jump[ jump[x] ];
+    return x;
+}
+
+/*=============================================================================
+Function: graph_deltas
+Description: Loads a graph from graph_cache.bin (or input.txt if there is no
+             cache), then applies delta files one after another for as long
+             as the user keeps naming them. Each delta costs time in
+             proportion to its record count, not to the graph. On request
+             the weight of the minimum spanning forest is printed after
+             every delta, at the cost of a pass over the whole graph. The
+             graph is saved back to graph_cache.bin at the end.
+             
+             Text deltas hold one record per line:
+                 + u v w     add the edge u-v with weight w
+                 - u v       remove the edge u-v
+                 = u v w     give the edge u-v weight w
+                 # ...       comment
+             Binary deltas start with the four bytes GWD1, then hold
+             records of one op byte ('+', '-' or '=') and three 32-bit
+             integers u, v, w in native byte order (w is ignored for '-').
+=============================================================================*/
+void graph_deltas()
+{
+    EdgeTable table;                // Graph being patched
+    string fileName;                // Delta file named by the user
+    int save;                       // Whether to rewrite input.txt
+    int report;                     // Whether to print the forest weight
+    
+    /** Load the cached graph, or input.txt **/
+    if ( read_graph_cache( table ) )
+    {
+        cout << "Loaded graph_cache.bin" << endl;
+    }
+    else
+    {
+        ifstream inputFile;         // Stores input file data to read from
+        
+        table.vertexCount = 0;
+        if ( !check_file( inputFile ) ) return;
+        create_graph( inputFile, table.G, table.vertexCount );
+        inputFile.close();
+        cout << "Loaded input.txt" << endl;
+    }
+    index_edges( table );
+    cout << "|V| = " << table.vertexCount << ", |E| = " << table.G.size() 
+         << endl << endl;
+    
+    do
+    {
+        printf(" Print the spanning forest weight after each delta?"
+               " (1 yes, 0 no)\n");
+        printf(" > ");
+        cin >> report;
+    } while ( !(report == 0 || report == 1) );
+    
+    /** Apply deltas until the user stops **/
+    while ( true )
+    {
+        DeltaCount count = { 0, 0, 0, 0 };
+        vector< int > treeEdges;    // Indices in G of the forest edges
+        
+        printf(" Delta file? (0 to finish)\n");
+        printf(" > ");
+        cin >> fileName;
+        
+        if ( fileName == "0" ) break;
+        if ( !apply_delta( table, fileName, count ) ) continue;
+        
+        cout << endl << count.added << " added, " << count.removed 
+             << " removed, " << count.reweighted << " reweighted, " 
+             << count.skipped << " skipped" << endl
+             << "|V| = " << table.vertexCount << ", |E| = " << table.G.size();
+        if ( report )
+            cout << ", spanning forest weight: " 
+                 << kkt_tree( table.G, table.vertexCount, treeEdges );
+        cout << endl << endl;
+    }
+    
+    do
+    {
+        printf(" Also rewrite input.txt? (1 yes, 0 no)\n");
+        printf(" > ");
+        cin >> save;
+    } while ( !(save == 0 || save == 1) );
+    
+    // The cache is stamped with input.txt as it is left behind
+    if ( save ) write_matrix( table );
+    write_graph_cache( table );
+    cout << endl << "Graph saved to graph_cache.bin" << endl << endl;
+}
+
+/*=============================================================================
+Function: index_edges
+Description: Rebuilds the vertex pair index of the table from its edges
+Parameters: table - edge table
+=============================================================================*/
+void index_edges( EdgeTable &table )
+{
+    table.index.clear();
+    for ( unsigned int i = 0; i < table.G.size(); i++ )
+    {
+        const WeightedEdge &e = table.G[i];
+        
+        table.index[ make_pair( e.getU(), e.getV() ) ] = i;
+    }
+}
+
+/*=============================================================================
+Function: input_stamp
+Description: Reads the size and modification time of input.txt, or -1 for
+             both if it does not exist
+Parameters: stamp - receives the size and the modification time
+=============================================================================*/
+void input_stamp( long long stamp[2] )
+{
+    struct stat info;               // File status of input.txt
+    
+    stamp[0] = stamp[1] = -1;
+    if ( stat( "input.txt", &info ) != 0 ) return;
+    
+    stamp[0] = info.st_size;
+    stamp[1] = info.st_mtime;
+}
+
+/*=============================================================================
+Function: read_graph_cache
+Description: Reads graph_cache.bin: the four bytes GWC2, the size and
+             modification time of input.txt when the cache was written as
+             64-bit integers, the vertex count, the edge count, then u, v, w
+             per edge as 32-bit integers, all in native byte order. Returns
+             false if there is no usable cache: a missing or damaged file,
+             an edge endpoint outside the vertex set, or an input.txt that
+             changed since the cache was written.
+Parameters: table - receives the graph
+=============================================================================*/
+bool read_graph_cache( EdgeTable &table )
+{
+    ifstream cache( "graph_cache.bin", ios::binary );
+    char magic[4];                  // File signature
+    long long source[2];            // Stamp of input.txt in the cache
+    long long current[2];           // Stamp of input.txt now
+    int header[2];                  // Vertex count, edge count
+    
+    if ( !cache.is_open() ) return false;
+    
+    cache.read( magic, 4 );
+    cache.read( (char *)source, sizeof( source ) );
+    cache.read( (char *)header, sizeof( header ) );
+    if ( !cache || string( magic, 4 ) != "GWC2" || header[0] < 0 || 
+         header[1] < 0 )
+        return false;
+    
+    input_stamp( current );
+    if ( source[0] != current[0] || source[1] != current[1] )
+    {
+        cout << "input.txt changed since graph_cache.bin was written; "
+             << "ignoring the cache" << endl;
+        return false;
+    }
+    
+    vector< int > data( 3 * (size_t)header[1] );
+    cache.read( (char *)data.data(), data.size() * sizeof( int ) );
+    if ( !cache ) return false;
+    
+    for ( int i = 0; i < header[1]; i++ )
+    {
+        if ( data[3*i] < 0 || data[3*i] >= header[0] ||
+             data[3*i+1] < 0 || data[3*i+1] >= header[0] )
+            return false;
+    }
+    
+    table.vertexCount = header[0];
+    table.G.clear();
+    table.G.reserve( header[1] );
+    for ( int i = 0; i < header[1]; i++ )
+        table.G.push_back( WeightedEdge( data[3*i], data[3*i+1], 
+                                         data[3*i+2] ) );
+    
+    return true;
+}
+
+/*=============================================================================
+Function: write_graph_cache
+Description: Writes the table to graph_cache.bin (see read_graph_cache)
+Parameters: table - edge table
+=============================================================================*/
+void write_graph_cache( const EdgeTable &table )
+{
+    ofstream cache( "graph_cache.bin", ios::binary );
+    int header[2] = { (int)table.vertexCount, (int)table.G.size() };
+    long long source[2];            // Stamp of input.txt
+    vector< int > data;             // u, v, w per edge
+    
+    data.reserve( 3 * table.G.size() );
+    for ( unsigned int i = 0; i < table.G.size(); i++ )
+    {
+        data.push_back( table.G[i].getU() );
+        data.push_back( table.G[i].getV() );
+        data.push_back( table.G[i].getW() );
+    }
+    
+    input_stamp( source );
+    cache.write( "GWC2", 4 );
+    cache.write( (const char *)source, sizeof( source ) );
+    cache.write( (const char *)header, sizeof( header ) );
+    cache.write( (const char *)data.data(), data.size() * sizeof( int ) );
+    cache.close();
+}
+
+/*=============================================================================
+Function: apply_delta
+Description: Applies every record of a text or binary delta file (told
+             apart by the GWD1 signature). Returns false if the file cannot
+             be opened or a text record is malformed; records before a
+             malformed one stay applied.
+Parameters: table - edge table
+            fileName - delta file
+            count - receives what the records did
+=============================================================================*/
+bool apply_delta( EdgeTable &table, const string &fileName, 
+                  DeltaCount &count )
+{
+    ifstream delta( fileName.c_str(), ios::binary );
+    char magic[4] = { 0, 0, 0, 0 }; // File signature, if binary
+    
+    if ( !delta.is_open() )
+    {
+        cout << "Could not open " << fileName << endl << endl;
+        return false;
+    }
+    
+    delta.read( magic, 4 );
+    
+    /** Binary records **/
+    if ( delta && string( magic, 4 ) == "GWD1" )
+    {
+        char op;
+        int field[3];
+        
+        while ( delta.read( &op, 1 ) && 
+                delta.read( (char *)field, sizeof( field ) ) )
+        {
+            apply_edge_record( table, op, field[0], field[1], field[2], 
+                               count );
+        }
+        return true;
+    }
+    
+    /** Text records **/
+    delta.clear();
+    delta.seekg( 0 );
+    
+    char op;
+    while ( delta >> op )
+    {
+        int a, b, w = 0;
+        
+        if ( op == '#' )
+        {
+            delta.ignore( numeric_limits< streamsize >::max(), '\n' );
+            continue;
+        }
+        
+        delta >> a >> b;
+        if ( op != '-' ) delta >> w;
+        
+        if ( !delta )
+        {
+            cout << "Malformed record in " << fileName << endl << endl;
+            return false;
+        }
+        apply_edge_record( table, op, a, b, w, count );
+    }
+    
+    return true;
+}
+
+/*=============================================================================
+Function: apply_edge_record
+Description: Adds, removes or reweights one edge. A removed edge is replaced
+             by the last edge of G so removals stay O(1) apart from the
+             index lookup. Adding an existing edge or touching a missing one
+             is counted as skipped; so is an unknown op or a zero weight.
+             Vertices past the end grow the vertex count, by at most 1024
+             per record and never beyond 2^24 vertices; records naming a
+             vertex further out are skipped as well.
+Parameters: table - edge table
+            op - '+' add, '-' remove, '=' reweight
+            a, b - ends of the edge
+            w - new weight
+            count - tallies the outcome
+=============================================================================*/
+void apply_edge_record( EdgeTable &table, char op, int a, int b, int w,
+                        DeltaCount &count )
+{
+    const long long MAX_GROWTH = 1024;      // New vertices one record may add
+    const long long MAX_VERTICES = 1 << 24; // Largest vertex count allowed
+    pair< int, int > key( max( a, b ), min( a, b ) );
+    map< pair< int, int >, int >::iterator found = table.index.find( key );
+    
+    if ( key.second < 0 || key.first >= MAX_VERTICES ||
+         key.first >= (long long)table.vertexCount + MAX_GROWTH ||
+         ( op != '-' && w == 0 ) )
+    {
+        count.skipped++;
+        return;
+    }
+    
+    if ( op == '+' && found == table.index.end() )
+    {
+        table.index[key] = table.G.size();
+        table.G.push_back( WeightedEdge( key.first, key.second, w ) );
+        table.vertexCount = max( table.vertexCount, 
+                                 (unsigned int)key.first + 1 );
+        count.added++;
+    }
+    else if ( op == '-' && found != table.index.end() )
+    {
+        int i = found->second;
+        const WeightedEdge &last = table.G.back();
+        
+        table.index[ make_pair( last.getU(), last.getV() ) ] = i;
+        table.G[i] = last;
+        table.G.pop_back();
+        table.index.erase( key );
+        count.removed++;
+    }
+    else if ( op == '=' && found != table.index.end() )
+    {
+        table.G[ found->second ] = WeightedEdge( key.first, key.second, w );
+        count.reweighted++;
+    }
+    else
+    {
+        count.skipped++;
+    }
+}
+
+/*=============================================================================
+Function: write_matrix
+Description: Writes the table to input.txt as a full weight matrix
+Parameters: table - edge table
+=============================================================================*/
+void write_matrix( const EdgeTable &table )
+{
+    vector< vector< int > > M;      // Weight matrix
+    ofstream outfile;               // Stores output file data
+    
+    graph_to_matrix( table.G, table.vertexCount, M );
+    
+    outfile.open( "input.txt" );
+    outfile << table.vertexCount << endl;
+    for ( unsigned int j = 0; j < table.vertexCount; j++ )
+    {
+        for ( unsigned int i = 0; i < table.vertexCount; i++ )
+        {
+            outfile << M[j][i] << ( i + 1 < table.vertexCount ? " " : "" );
+        }
+        outfile << endl;
+    }
+    outfile.close();
+    
+    cout << "Graph written to input.txt" << endl;
+}
+
+/*=============================================================================
+Function: minimum_cut
+Description: Finds a lightest set of edges of input.txt whose removal
+             disconnects G, with Stoer-Wagner (exact) or Karger-Stein
+             (randomized, correct with high probability)
+=============================================================================*/
+void minimum_cut()
+{
+    unsigned int vertexCount = 0;       // Stores vertex count from input file
+    int engine;                         // Algorithm used
+    long long cutWeight;                // Weight of the cut found
+    vector< WeightedEdge > G;           // Our graph
+    vector< WeightedEdge > C;           // Edges crossing the cut
+    vector< char > side;                // Marks one side of the cut
+    
+    if ( !load_graph( G, vertexCount ) ) return;
+    
+    for ( unsigned int i = 0; i < G.size(); i++ )
+    {
+        if ( G[i].getW() < 0 )
+        {
+            cout << "Edge weights must not be negative." << endl << endl;
+            return;
+        }
+    }
+    
+    do
+    {
+        printf(" Which engine?\n");
+        printf(" 1: Stoer-Wagner\n");
+        printf(" 2: Karger-Stein (randomized)\n");
+        printf(" > ");
+        cin >> engine;
+    } while ( !(engine == 1 || engine == 2) );
+    
+    if ( engine == 1 )
+    {
+        cout << endl;
+        cutWeight = stoer_wagner( G, vertexCount, side );
+    }
+    else
+    {
+        int trials;                     // Independent contraction runs
+        unsigned int seed;              // Base seed of the random streams
+        double logN = log( (double)vertexCount );
+        
+        do
+        {
+            printf(" How many trials? (0 for %d)\n", 
+                   (int)ceil( logN * logN ) + 1);
+            printf(" > ");
+            cin >> trials;
+        } while ( !(trials >= 0) );
+        if ( trials == 0 ) trials = (int)ceil( logN * logN ) + 1;
+        
+        printf(" Random seed?\n");
+        printf(" > ");
+        cin >> seed;
+        cout << endl;
+        
+        cutWeight = karger_stein( G, vertexCount, trials, seed, side );
+    }
+    
+    /** Print the cut **/
+    cout << "Vertices on one side of the cut:" << endl << "  ";
+    for ( unsigned int x = 0; x < vertexCount; x++ )
+        if ( side[x] ) cout << " " << x;
+    cout << endl << endl;
+    
+    for ( unsigned int i = 0; i < G.size(); i++ )
+        if ( side[ G[i].getU() ] != side[ G[i].getV() ] ) C.push_back( G[i] );
+    
+    cout << "Edges crossing the cut:" << endl;
+    print_graph(C);
+    
+    cout << "Weight of the minimum cut: " << endl 
+         << "   " << cutWeight << endl << endl;
+}
+
+/*=============================================================================
+Function: stoer_wagner
+Description: Stoer-Wagner global minimum cut on the dense weight matrix,
+             O(|V|^3). Each phase grows a maximum adjacency order by
+             scanning the connection weights of all remaining vertices,
+             which on a matrix is as fast as a heap or bucket queue; the
+             last vertex of the order gives a candidate cut and is merged
+             into the one before it. The scans of large phases are split
+             across threads; ties go to the lower vertex so the result does
+             not depend on the thread count.
+Parameters: G - weighted edges stored as UVW vector set
+            vertexCount - verticy cardinality for G
+            side - receives a mark on the vertices of one side of the cut
+=============================================================================*/
+long long stoer_wagner( const vector< WeightedEdge > &G, 
+                        unsigned int vertexCount, vector< char > &side )
+{
+    int n = vertexCount;
+    vector< vector< long long > > W( n, vector< long long >( n, 0 ) );
+                                            // Weights between merged groups
+    vector< vector< int > > members( n );   // Original vertices per group
+    vector< int > alive( n );               // Groups still unmerged
+    vector< long long > key( n );           // Connection to the order
+    vector< char > added( n );              // Marks groups in the order
+    long long best = numeric_limits< long long >::max();
+    
+    for ( unsigned int i = 0; i < G.size(); i++ )
+    {
+        if ( G[i].getU() == G[i].getV() ) continue;
+        W[ G[i].getU() ][ G[i].getV() ] += G[i].getW();
+        W[ G[i].getV() ][ G[i].getU() ] += G[i].getW();
+    }
+    for ( int x = 0; x < n; x++ )
+    {
+        members[x].push_back( x );
+        alive[x] = x;
+    }
+    side.assign( n, 0 );
+    if ( n < 2 ) return 0;
+    
+    /** One phase per merge **/
+    for ( int m = n; m > 1; m-- )
+    {
+        int prev = -1;              // Second to last group of the order
+        int last = alive[0];        // Last group of the order
+        long long bestKey = -1;     // Largest key of this step
+        int bestAt = -1;            // Group holding it
+        
+        for ( int j = 0; j < m; j++ )
+        {
+            key[ alive[j] ] = 0;
+            added[ alive[j] ] = 0;
+        }
+        added[last] = 1;
+        
+        #pragma omp parallel if ( m >= 4096 )
+        {
+            for ( int step = 1; step < m; step++ )
+            {
+                long long localKey = -1;    // This thread's best key
+                int localAt = -1;           // and its group
+                
+                #pragma omp for nowait
+                for ( int j = 0; j < m; j++ )
+                {
+                    int v = alive[j];
+                    
+                    if ( added[v] ) continue;
+                    key[v] += W[last][v];
+                    if ( key[v] > localKey || 
+                         ( key[v] == localKey && v < localAt ) )
+                    {
+                        localKey = key[v];
+                        localAt = v;
+                    }
+                }
+                
+                #pragma omp critical (stoer_wagner_best)
+                {
+                    if ( localKey > bestKey || 
+                         ( localKey == bestKey && localAt >= 0 && 
+                           localAt < bestAt ) )
+                    {
+                        bestKey = localKey;
+                        bestAt = localAt;
+                    }
+                }
+                #pragma omp barrier
+                
+                #pragma omp single
+                {
+                    prev = last;
+                    last = bestAt;
+                    added[last] = 1;
+                    bestKey = -1;
+                    bestAt = -1;
+                }
+            }
+        }
+        
+        /** Cut of the phase: the last group against the rest **/
+        if ( key[last] < best )
+        {
+            best = key[last];
+            side.assign( n, 0 );
+            for ( unsigned int i = 0; i < members[last].size(); i++ )
+                side[ members[last][i] ] = 1;
+        }
+        
+        /** Merge the last group into the one before it **/
+        for ( int j = 0; j < m; j++ )
+        {
+            int v = alive[j];
+            
+            W[prev][v] += W[last][v];
+            W[v][prev] = W[prev][v];
+        }
+        W[prev][prev] = 0;
+        members[prev].insert( members[prev].end(), members[last].begin(),
+                              members[last].end() );
+        alive.erase( find( alive.begin(), alive.begin() + m, last ) );
+    }
+    
+    return best;
+}
+
+/*=============================================================================
+Function: karger_stein
+Description: Karger-Stein recursive contraction, O(|V|^2 log^3 |V|) for a
+             dense graph over the default trial count; each trial finds a
+             minimum cut with probability about 1/log |V|. Trials run in
+             parallel, trial t using the random stream seeded by (seed, t),
+             and the lightest cut of the lowest trial wins ties.
+Parameters: G - weighted edges stored as UVW vector set
+            vertexCount - verticy cardinality for G
+            trials - number of independent runs
+            seed - base seed of the random streams
+            side - receives a mark on the vertices of one side of the cut
+=============================================================================*/
+long long karger_stein( const vector< WeightedEdge > &G, 
+                        unsigned int vertexCount, int trials, 
+                        unsigned int seed, vector< char > &side )
+{
+    DisjointSet components( vertexCount );  // Components of G
+    vector< int > label( vertexCount );     // Identity labelling
+    vector< long long > result( trials );   // Cut weight of each trial
+    vector< vector< char > > sides( trials );   
+                                            // Cut side of each trial
+    int winner = 0;                         // Trial reported
+    
+    /** A disconnected graph has an empty cut **/
+    for ( unsigned int i = 0; i < G.size(); i++ )
+        components.join( G[i].getU(), G[i].getV() );
+    
+    side.assign( vertexCount, 0 );
+    for ( unsigned int x = 0; x < vertexCount; x++ )
+    {
+        side[x] = ( components.find( x ) == components.find( 0 ) );
+        label[x] = x;
+    }
+    if ( count( side.begin(), side.end(), 1 ) < (int)vertexCount ) return 0;
+    
+    #pragma omp parallel for schedule(dynamic)
+    for ( int t = 0; t < trials; t++ )
+    {
+        seed_seq stream{ seed, (unsigned int)t };
+        mt19937_64 rng( stream );
+        
+        result[t] = numeric_limits< long long >::max();
+        contract_cut( G, vertexCount, label, rng, result[t], sides[t] );
+    }
+    
+    for ( int t = 1; t < trials; t++ )
+        if ( result[t] < result[winner] ) winner = t;
+    
+    side = sides[winner];
+    return result[winner];
+}
+
+/*=============================================================================
+Function: contract_cut
+Description: One branch of the Karger-Stein recursion. Small graphs are
+             solved exactly with Stoer-Wagner; larger ones are contracted
+             twice, independently, down to about |V|/sqrt(2) vertices and
+             each contraction is recursed on. Contracting in the order of
+             exponential keys with rate w picks edges in proportion to
+             their weight.
+Parameters: G - edges of the current, contracted graph
+            vertexCount - verticy cardinality of the current graph
+            label - current vertex holding each original vertex
+            rng - random source of the contractions
+            best - lightest cut found so far, updated in place
+            side - marks one side of the lightest cut, over the original
+                   vertices
+=============================================================================*/
+void contract_cut( const vector< WeightedEdge > &G, int vertexCount, 
+                   const vector< int > &label, mt19937_64 &rng, 
+                   long long &best, vector< char > &side )
+{
+    /** Base case: small graphs are solved exactly **/
+    if ( vertexCount <= 64 )
+    {
+        vector< char > part;        // Cut side over the current vertices
+        long long weight = stoer_wagner( G, vertexCount, part );
+        
+        if ( weight < best )
+        {
+            best = weight;
+            side.assign( label.size(), 0 );
+            for ( unsigned int x = 0; x < label.size(); x++ )
+                side[x] = part[ label[x] ];
+        }
+        return;
+    }
+    
+    int target = (int)ceil( 1 + vertexCount / sqrt( 2.0 ) );
+    uniform_real_distribution< double > uniform( 0.0, 1.0 );
+    
+    for ( int branch = 0; branch < 2; branch++ )
+    {
+        vector< pair< double, int > > order;    // (key, edge) to contract
+        DisjointSet groups( vertexCount );      // Contracted vertices
+        vector< int > rename( vertexCount, -1 );// New number of each group
+        vector< int > next( label.size() );     // Labels after contraction
+        vector< pair< pair< int, int >, int > > merged;
+                                                // Contracted edges by ends
+        vector< WeightedEdge > H;               // Contracted graph
+        int left = vertexCount;                 // Vertices remaining
+        int count = 0;                          // Vertices numbered so far
+        
+        for ( unsigned int i = 0; i < G.size(); i++ )
+        {
+            if ( G[i].getW() == 0 ) continue;
+            order.push_back( make_pair( -log( 1.0 - uniform( rng ) ) 
+                                        / G[i].getW(), i ) );
+        }
+        sort( order.begin(), order.end() );
+        
+        for ( unsigned int k = 0; k < order.size() && left > target; k++ )
+        {
+            const WeightedEdge &e = G[ order[k].second ];
+            
+            if ( groups.join( e.getU(), e.getV() ) ) left--;
+        }
+        
+        for ( int x = 0; x < vertexCount; x++ )
+        {
+            int r = groups.find( x );
+            
+            if ( rename[r] < 0 ) rename[r] = count++;
+        }
+        for ( unsigned int x = 0; x < label.size(); x++ )
+            next[x] = rename[ groups.find( label[x] ) ];
+        
+        /** Rebuild the edges, adding up parallel ones **/
+        for ( unsigned int i = 0; i < G.size(); i++ )
+        {
+            int a = rename[ groups.find( G[i].getU() ) ];
+            int b = rename[ groups.find( G[i].getV() ) ];
+            
+            if ( a == b ) continue;
+            merged.push_back( make_pair( make_pair( max( a, b ), min( a, b ) ),
+                                         G[i].getW() ) );
+        }
+        sort( merged.begin(), merged.end() );
+        for ( unsigned int i = 0; i < merged.size(); i++ )
+        {
+            if ( i > 0 && merged[i].first == merged[i-1].first )
+            {
+                const WeightedEdge &e = H.back();
+                H.back() = WeightedEdge( e.getU(), e.getV(), 
+                                         e.getW() + merged[i].second );
+            }
+            else
+            {
+                H.push_back( WeightedEdge( merged[i].first.first, 
+                                           merged[i].first.second, 
+                                           merged[i].second ) );
+            }
+        }
+        
+        contract_cut( H, count, next, rng, best, side );
+    }
+}
+
+/*=============================================================================
+Function: gomory_hu
+Description: Builds a Gomory-Hu tree of input.txt: a weighted tree on the
+             same vertices in which the minimum cut between any two
+             vertices weighs as much as the lightest edge on their tree
+             path. Prints the tree, writes every pairwise minimum cut to
+             min_cuts.txt as a matrix, then answers pair queries. Cut
+             weights are kept as long long, since a cut can sum many edges.
+=============================================================================*/
+void gomory_hu()
+{
+    unsigned int vertexCount = 0;       // Stores vertex count from input file
+    vector< WeightedEdge > G;           // Our graph
+    vector< int > parent;               // Tree parent of each vertex of T
+    vector< long long > weight;         // Weight of the edge to the parent
+    vector< vector< long long > > cut;  // Minimum cut of every pair
+    ofstream outfile;                   // Stores output file data for cuts
+    
+    if ( !load_graph( G, vertexCount ) ) return;
+    
+    for ( unsigned int i = 0; i < G.size(); i++ )
+    {
+        if ( G[i].getW() < 0 )
+        {
+            cout << "Edge weights must not be negative." << endl << endl;
+            return;
+        }
+    }
+    
+    gomory_hu_tree( G, vertexCount, parent, weight );
+    
+    /** Print T, as print_graph would **/
+    cout << endl << "The Gomory-Hu tree T of G:" << endl;
+    for ( unsigned int s = 1; s < vertexCount; s++ )
+    {
+        cout << "   Edge " << s - 1 << ": verts<" << s << ", " << parent[s]
+             << "> weight[ " << weight[s] << " ]" << endl;
+    }
+    cout << endl;
+    
+    /** Write all pairwise cuts **/
+    tree_path_minimums( parent, weight, cut );
+    
+    outfile.open( "min_cuts.txt" );
+    outfile << vertexCount << endl;
+    for ( unsigned int a = 0; a < vertexCount; a++ )
+    {
+        for ( unsigned int b = 0; b < vertexCount; b++ )
+            outfile << cut[a][b] << ( b + 1 < vertexCount ? " " : "" );
+        outfile << endl;
+    }
+    outfile.close();
+    cout << "Minimum cut of every vertex pair written to min_cuts.txt" 
+         << endl << endl;
+    
+    /** Answer pair queries **/
+    while ( true )
+    {
+        int a, b;
+        
+        do
+        {
+            printf(" Minimum cut between which two vertices? (-1 to finish)\n");
+            printf(" > ");
+            cin >> a;
+            if ( a == -1 ) break;
+            cin >> b;
+        } while ( !(a >= 0 && a < (int)vertexCount && 
+                    b >= 0 && b < (int)vertexCount && a != b) );
+        
+        if ( a == -1 ) break;
+        cout << "   " << cut[a][b] << endl;
+    }
+    cout << endl;
+}
+
+/*=============================================================================
+Function: gomory_hu_tree
+Description: Gusfield's construction of a Gomory-Hu tree with |V|-1 maximum
+             flows on the original graph (no contractions). Vertex s starts
+             hanging from vertex 0; the flow from s to its parent t gives
+             the weight of the tree edge s-t, and every later vertex on the
+             source side of that cut that also hangs from t is moved to hang
+             from s. Each flow depends on the parents left by the ones
+             before it, so the flows run one after another.
+Parameters: G - weighted edges stored as UVW vector set
+            vertexCount - verticy cardinality for G
+            parent - receives the tree parent of each vertex (0 at vertex 0)
+            weight - receives the cut weight of the edge from each vertex
+                     to its parent (0 at vertex 0)
+=============================================================================*/
+void gomory_hu_tree( const vector< WeightedEdge > &G, 
+                     unsigned int vertexCount, vector< int > &parent,
+                     vector< long long > &weight )
+{
+    FlowNetwork network( vertexCount );     // G with both arc directions
+    vector< char > side;                    // Source side of the last cut
+    
+    parent.assign( vertexCount, 0 );
+    weight.assign( vertexCount, 0 );
+    
+    for ( unsigned int i = 0; i < G.size(); i++ )
+    {
+        if ( G[i].getU() == G[i].getV() ) continue;
+        network.add_edge( G[i].getU(), G[i].getV(), G[i].getW(), 
+                          G[i].getW() );
+    }
+    
+    for ( unsigned int s = 1; s < vertexCount; s++ )
+    {
+        int t = parent[s];
+        
+        network.reset();
+        weight[s] = network.max_flow( s, t );
+        network.source_side( s, side );
+        
+        for ( unsigned int x = s + 1; x < vertexCount; x++ )
+            if ( side[x] && parent[x] == t ) parent[x] = s;
+    }
+}
+
+/*=============================================================================
+Function: tree_path_minimums
+Description: Lightest edge weight on the path between every pair of
+             vertices of a tree, by a search from each vertex, O(|V|^2)
+Parameters: parent - tree parent of each vertex other than 0
+            weight - weight of the edge from each vertex to its parent
+            cut - receives the lightest path weight of each pair (0 on the
+                  diagonal)
+=============================================================================*/
+void tree_path_minimums( const vector< int > &parent, 
+                         const vector< long long > &weight,
+                         vector< vector< long long > > &cut )
+{
+    unsigned int vertexCount = parent.size();
+    vector< vector< int > > adj( vertexCount );
+                                    // Tree neighbours of each vertex; the
+                                    // edge x-y weighs weight of the child
+    
+    for ( unsigned int s = 1; s < vertexCount; s++ )
+    {
+        adj[s].push_back( parent[s] );
+        adj[ parent[s] ].push_back( s );
+    }
+    cut.assign( vertexCount, vector< long long >( vertexCount, 0 ) );
+    
+    #pragma omp parallel for schedule(dynamic)
+    for ( int s = 0; s < (int)vertexCount; s++ )
+    {
+        vector< char > seen( vertexCount, 0 );  // Marks reached vertices
+        vector< int > stack( 1, s );            // Vertices left to expand
+        
+        seen[s] = 1;
+        cut[s][s] = numeric_limits< long long >::max();
+        while ( !stack.empty() )
+        {
+            int x = stack.back();
+            stack.pop_back();
+            
+            for ( unsigned int i = 0; i < adj[x].size(); i++ )
+            {
+                int y = adj[x][i];
+                long long w = ( parent[y] == x && y != 0 ) ? weight[y] 
+                                                           : weight[x];
+                
+                if ( seen[y] ) continue;
+                
+                seen[y] = 1;
+                cut[s][y] = min( cut[s][x], w );
+                stack.push_back( y );
+            }
+        }
+        cut[s][s] = 0;
+    }
+}
+
+/*=============================================================================
+Function: FlowNetwork::add_edge
+Description: Adds the arc a -> b and its twin b -> a
+Parameters: a, b - ends of the edge
+            forward - capacity from a to b
+            backward - capacity from b to a
+=============================================================================*/
+void FlowNetwork::add_edge( int a, int b, long long forward, 
+                            long long backward )
+{
+    to.push_back( b );
+    next.push_back( head[a] );
+    head[a] = to.size() - 1;
+    original.push_back( forward );
+    
+    to.push_back( a );
+    next.push_back( head[b] );
+    head[b] = to.size() - 1;
+    original.push_back( backward );
+    
+    capacity.push_back( forward );
+    capacity.push_back( backward );
+}
+
+/*=============================================================================
+Function: FlowNetwork::build_levels
+Description: Breadth first search from s over arcs with spare capacity.
+             Returns true if t was reached.
+Parameters: s - source
+            t - sink
+=============================================================================*/
+bool FlowNetwork::build_levels( int s, int t )
+{
+    vector< int > order( 1, s );    // Vertices in breadth first order
+    
+    level.assign( head.size(), -1 );
+    level[s] = 0;
+    
+    for ( unsigned int i = 0; i < order.size(); i++ )
+    {
+        int x = order[i];
+        
+        for ( int a = head[x]; a >= 0; a = next[a] )
+        {
+            if ( capacity[a] > 0 && level[ to[a] ] < 0 )
+            {
+                level[ to[a] ] = level[x] + 1;
+                order.push_back( to[a] );
+            }
+        }
+    }
+    
+    return level[t] >= 0;
+}
+
+/*=============================================================================
+Function: FlowNetwork::push
+Description: Sends up to limit units from x to t along arcs that go one
+             level deeper, returning the amount sent
+Parameters: x - current vertex
+            t - sink
+            limit - most flow to send
+=============================================================================*/
+long long FlowNetwork::push( int x, int t, long long limit )
+{
+    if ( x == t ) return limit;
+    
+    for ( int &a = cursor[x]; a >= 0; a = next[a] )
+    {
+        int y = to[a];
+        
+        if ( capacity[a] <= 0 || level[y] != level[x] + 1 ) continue;
+        
+        long long sent = push( y, t, min( limit, capacity[a] ) );
+        if ( sent > 0 )
+        {
+            capacity[a] -= sent;
+            capacity[a ^ 1] += sent;
+            return sent;
+        }
+    }
+    
+    return 0;
+}
+
+/*=============================================================================
+Function: FlowNetwork::max_flow
+Description: Dinic's algorithm: repeatedly levels the residual network and
+             saturates it with blocking flows, O(|V|^2 |E|)
+Parameters: s - source
+            t - sink
+=============================================================================*/
+long long FlowNetwork::max_flow( int s, int t )
+{
+    long long total = 0;    // Flow sent so far
+    
+    while ( build_levels( s, t ) )
+    {
+        cursor = head;
+        
+        long long sent;
+        while ( ( sent = push( s, t, numeric_limits< long long >::max() ) ) 
+                > 0 )
+            total += sent;
+    }
+    
+    return total;
+}
+
+/*=============================================================================
+Function: FlowNetwork::source_side
+Description: Marks the vertices reachable from s over arcs with spare
+             capacity; after a maximum flow this is the source side of a
+             minimum cut
+Parameters: s - source
+            side - receives the marks
+=============================================================================*/
+void FlowNetwork::source_side( int s, vector< char > &side ) const
+{
+    vector< int > stack( 1, s );    // Vertices left to expand
+    
+    side.assign( head.size(), 0 );
+    side[s] = 1;
+    
+    while ( !stack.empty() )
+    {
+        int x = stack.back();
+        stack.pop_back();
+        
+        for ( int a = head[x]; a >= 0; a = next[a] )
+        {
+            if ( capacity[a] > 0 && !side[ to[a] ] )
+            {
+                side[ to[a] ] = 1;
+                stack.push_back( to[a] );
+            }
+        }
+    }
+}
+
+/*=============================================================================
+Function: maximum_flow
+Description: Maximum flow between two vertices of input.txt, reading each
+             edge weight as a capacity in both directions. Prints the flow
+             value, the source side of a minimum cut, the cut edges and,
+             for push-relabel, its operation counts.
+=============================================================================*/
+void maximum_flow()
+{
+    unsigned int vertexCount = 0;       // Stores vertex count from input file
+    int source, sink;                   // Ends of the flow
+    int engine;                         // Algorithm used
+    long long flow;                     // Value of the maximum flow
+    FlowCounters counters = { 0, 0, 0, 0 };
+                                        // Push-relabel operation counts
+    vector< WeightedEdge > G;           // Our graph
+    vector< WeightedEdge > C;           // Edges of the minimum cut
+    vector< char > side;                // Source side of the cut
+    
+    if ( !load_graph( G, vertexCount ) ) return;
+    
+    for ( unsigned int i = 0; i < G.size(); i++ )
+    {
+        if ( G[i].getW() < 0 )
+        {
+            cout << "Edge weights must not be negative." << endl << endl;
+            return;
+        }
+    }
+    
+    do
+    {
+        printf(" Source and sink vertices?\n");
+        printf(" > ");
+        cin >> source >> sink;
+    } while ( !(source >= 0 && source < (int)vertexCount && sink >= 0 && 
+                sink < (int)vertexCount && source != sink) );
+    
+    do
+    {
+        printf(" Which engine?\n");
+        printf(" 1: Push-relabel (highest label)\n");
+        printf(" 2: Dinic\n");
+        printf(" > ");
+        cin >> engine;
+    } while ( !(engine == 1 || engine == 2) );
+    cout << endl;
+    
+    FlowNetwork network( vertexCount );
+    for ( unsigned int i = 0; i < G.size(); i++ )
+    {
+        if ( G[i].getU() == G[i].getV() ) continue;
+        network.add_edge( G[i].getU(), G[i].getV(), G[i].getW(), 
+                          G[i].getW() );
+    }
+    
+    if ( engine == 1 )
+    {
+        flow = network.push_relabel( source, sink, counters );
+        network.preflow_cut( sink, side );
+    }
+    else
+    {
+        flow = network.max_flow( source, sink );
+        network.source_side( source, side );
+    }
+    
+    /** Print the cut **/
+    cout << "Source side of a minimum cut:" << endl << "  ";
+    for ( unsigned int x = 0; x < vertexCount; x++ )
+        if ( side[x] ) cout << " " << x;
+    cout << endl << endl;
+    
+    for ( unsigned int i = 0; i < G.size(); i++ )
+        if ( side[ G[i].getU() ] != side[ G[i].getV() ] ) C.push_back( G[i] );
+    
+    cout << "Edges of the minimum cut:" << endl;
+    print_graph(C);
+    
+    if ( engine == 1 )
+    {
+        cout << "Pushes: " << counters.pushes << ", relabels: " 
+             << counters.relabels << ", global relabels: " 
+             << counters.globals << ", gaps: " << counters.gaps 
+             << endl << endl;
+    }
+    
+    cout << "Value of the maximum flow from " << source << " to " << sink 
+         << ": " << endl << "   " << flow << endl << endl;
+}
+
+/*=============================================================================
+Function: FlowNetwork::push_relabel
+Description: First phase of highest-label push-relabel, O(|V|^2 sqrt|E|).
+             The source floods its arcs; then the active vertex with the
+             highest label pushes its excess down admissible arcs, being
+             relabeled when it has none. Labels are reset to exact
+             distances to the sink after every O(|V| + |E|) units of
+             relabel work (global relabeling), and when no vertex is left
+             at some height every vertex above it is lifted out at once
+             (gap heuristic). Vertices lifted to |V| cannot reach the sink,
+             so their excess stays put: the sink's excess is the flow value.
+Parameters: s - source
+            t - sink
+            counters - receives the operation counts
+=============================================================================*/
+long long FlowNetwork::push_relabel( int s, int t, FlowCounters &counters )
+{
+    int n = head.size();
+    vector< int > height;                   // Label of each vertex
+    vector< long long > excess( n, 0 );     // Inflow minus outflow
+    vector< int > count( n + 1, 0 );        // Vertices at each height < n
+    vector< vector< int > > bucket( n );    // Active vertices per height
+    long long work = 0;                     // Relabel work since the last
+                                            // global relabel
+    int highest = 0;                        // Top nonempty bucket, or less
+    
+    capacity = original;
+    cursor = head;
+    
+    /** Flood the source's arcs **/
+    for ( int a = head[s]; a >= 0; a = next[a] )
+    {
+        excess[ to[a] ] += capacity[a];
+        excess[s] -= capacity[a];
+        capacity[a ^ 1] += capacity[a];
+        capacity[a] = 0;
+    }
+    
+    while ( true )
+    {
+        /** Exact labels and fresh buckets **/
+        if ( work == 0 )
+        {
+            global_relabel( s, t, height );
+            counters.globals++;
+            
+            count.assign( n + 1, 0 );
+            highest = 0;
+            for ( int h = 0; h < n; h++ ) bucket[h].clear();
+            for ( int x = 0; x < n; x++ )
+            {
+                if ( height[x] >= n ) continue;
+                count[ height[x] ]++;
+                if ( x != s && x != t && excess[x] > 0 )
+                {
+                    bucket[ height[x] ].push_back( x );
+                    highest = max( highest, height[x] );
+                }
+            }
+            cursor = head;
+            work = 1;
+        }
+        
+        while ( highest >= 0 && bucket[highest].empty() ) highest--;
+        if ( highest < 0 ) break;
+        
+        int x = bucket[highest].back();
+        bucket[highest].pop_back();
+        
+        // Entries left behind by the gap heuristic are skipped
+        if ( height[x] != highest || excess[x] == 0 ) continue;
+        
+        /** Discharge x **/
+        while ( excess[x] > 0 )
+        {
+            int &a = cursor[x];
+            
+            if ( a < 0 )
+            {
+                int old = height[x];
+                int lowest = 2 * n;
+                
+                counters.relabels++;
+                for ( int b = head[x]; b >= 0; b = next[b] )
+                {
+                    if ( capacity[b] > 0 ) lowest = min( lowest, 
+                                                         height[ to[b] ] );
+                    work++;
+                }
+                work += 12;
+                
+                count[old]--;
+                if ( count[old] == 0 )
+                {
+                    // Nothing below can reach the vertices above old
+                    counters.gaps++;
+                    for ( int y = 0; y < n; y++ )
+                    {
+                        if ( height[y] > old && height[y] < n )
+                        {
+                            count[ height[y] ]--;
+                            height[y] = n;
+                        }
+                    }
+                    height[x] = n;
+                    break;
+                }
+                
+                height[x] = min( lowest + 1, n );
+                if ( height[x] >= n ) break;
+                count[ height[x] ]++;
+                a = head[x];
+                continue;
+            }
+            
+            int y = to[a];
+            if ( capacity[a] > 0 && height[x] == height[y] + 1 )
+            {
+                long long sent = min( excess[x], capacity[a] );
+                
+                counters.pushes++;
+                if ( excess[y] == 0 && y != t && y != s )
+                {
+                    bucket[ height[y] ].push_back( y );
+                }
+                capacity[a] -= sent;
+                capacity[a ^ 1] += sent;
+                excess[x] -= sent;
+                excess[y] += sent;
+            }
+            else
+            {
+                a = next[a];
+            }
+        }
+        
+        if ( height[x] < n )
+            highest = max( highest, height[x] );
+        
+        if ( work > 6 * (long long)n + (long long)to.size() ) work = 0;
+    }
+    
+    return excess[t];
+}
+
+/*=============================================================================
+Function: FlowNetwork::global_relabel
+Description: Sets every label to the residual distance to the sink by a
+             backward breadth first search; vertices that cannot reach the
+             sink, and the source, get |V|. Large frontiers are scanned in
+             parallel; the new labels are then written by one thread, so
+             the result does not depend on the thread count.
+Parameters: s - source
+            t - sink
+            height - receives the labels
+=============================================================================*/
+void FlowNetwork::global_relabel( int s, int t, vector< int > &height ) const
+{
+    int n = head.size();
+    vector< int > frontier( 1, t );     // Vertices at the current distance
+    
+    height.assign( n, n );
+    height[t] = 0;
+    
+    for ( int d = 1; !frontier.empty(); d++ )
+    {
+        vector< int > found;            // Candidates one step further out
+        
+        #pragma omp parallel if ( frontier.size() >= 4096 )
+        {
+            vector< int > local;        // This thread's candidates
+            
+            #pragma omp for nowait
+            for ( int i = 0; i < (int)frontier.size(); i++ )
+            {
+                int x = frontier[i];
+                
+                // Arc a leaves x; its twin enters x from to[a]
+                for ( int a = head[x]; a >= 0; a = next[a] )
+                {
+                    if ( capacity[a ^ 1] > 0 && height[ to[a] ] == n && 
+                         to[a] != s )
+                        local.push_back( to[a] );
+                }
+            }
+            
+            #pragma omp critical (global_relabel_found)
+            found.insert( found.end(), local.begin(), local.end() );
+        }
+        
+        sort( found.begin(), found.end() );
+        frontier.clear();
+        for ( unsigned int i = 0; i < found.size(); i++ )
+        {
+            if ( height[ found[i] ] != n ) continue;
+            height[ found[i] ] = d;
+            frontier.push_back( found[i] );
+        }
+    }
+}
+
+/*=============================================================================
+Function: FlowNetwork::preflow_cut
+Description: Marks the vertices that cannot reach t over arcs with spare
+             capacity. After a maximum preflow (or flow) these form the
+             source side of a minimum cut.
+Parameters: t - sink
+            side - receives the marks
+=============================================================================*/
+void FlowNetwork::preflow_cut( int t, vector< char > &side ) const
+{
+    vector< int > stack( 1, t );    // Vertices left to expand
+    
+    side.assign( head.size(), 1 );
+    side[t] = 0;
+    
+    while ( !stack.empty() )
+    {
+        int x = stack.back();
+        stack.pop_back();
+        
+        // Arc a leaves x; its twin enters x from to[a]
+        for ( int a = head[x]; a >= 0; a = next[a] )
+        {
+            if ( capacity[a ^ 1] > 0 && side[ to[a] ] )
+            {
+                side[ to[a] ] = 0;
+                stack.push_back( to[a] );
+            }
+        }
+    }
+}
+
+/*=============================================================================
+Function: maximum_matching
+Description: Finds a largest set of edges of input.txt with no shared
+             vertex (weights are ignored). Bipartite graphs use
+             Hopcroft-Karp, others Edmonds' blossom algorithm; both start
+             from a greedy matching.
+=============================================================================*/
+void maximum_matching()
+{
+    unsigned int vertexCount = 0;       // Stores vertex count from input file
+    int warmStart;                      // Size of the greedy matching
+    int size;                           // Size of the maximum matching
+    int rounds = 0;                     // Phases or augmentations done
+    bool bipartite;                     // Whether G has two sides
+    vector< WeightedEdge > G;           // Our graph
+    vector< WeightedEdge > M;           // Our matching
+    vector< vector< int > > adj;        // Incident edges of each vertex
+    vector< vector< int > > near;       // Neighbours of each vertex
+    vector< int > color;                // Side of each vertex if bipartite
+    vector< int > match;                // Partner of each vertex, or -1
+    
+    if ( !load_graph( G, vertexCount ) ) return;
+    
+    build_adjacency( G, vertexCount, adj );
+    near.assign( vertexCount, vector< int >() );
+    for ( unsigned int x = 0; x < vertexCount; x++ )
+    {
+        for ( unsigned int i = 0; i < adj[x].size(); i++ )
+        {
+            const WeightedEdge &e = G[ adj[x][i] ];
+            near[x].push_back( ( e.getU() == (int)x ) ? e.getV() : e.getU() );
+        }
+    }
+    
+    /** Greedy warm start, then the exact engine **/
+    warmStart = greedy_matching( near, match );
+    bipartite = two_color( near, color );
+    
+    if ( bipartite )
+    {
+        size = hopcroft_karp( near, color, match, rounds );
+    }
+    else
+    {
+        BlossomSearch search;
+        
+        search.adj = near;
+        search.match = match;
+        size = blossom_matching( search, rounds );
+        match = search.match;
+    }
+    
+    for ( unsigned int i = 0; i < G.size(); i++ )
+        if ( G[i].getU() != G[i].getV() && match[ G[i].getU() ] == G[i].getV() )
+            M.push_back( G[i] );
+    
+    /** Print M **/
+    cout << endl << "A maximum matching M of G:" << endl;
+    print_graph(M);
+    
+    cout << ( bipartite ? "G is bipartite: Hopcroft-Karp, " 
+                        : "G is not bipartite: Edmonds blossom, " )
+         << rounds << ( bipartite ? " phases" : " augmentations" ) 
+         << " after a greedy start of " << warmStart << " edges" 
+         << endl << endl;
+    
+    cout << "Size of M: " << endl 
+         << "   " << size << endl << endl;
+}
+
+/*=============================================================================
+Function: two_color
+Description: Splits the vertices into two sides with every edge between
+             them, returning false if G has an odd cycle
+Parameters: adj - neighbours of each vertex
+            color - receives the side of each vertex, 0 or 1
+=============================================================================*/
+bool two_color( const vector< vector< int > > &adj, vector< int > &color )
+{
+    vector< int > stack;    // Vertices left to expand
+    
+    color.assign( adj.size(), -1 );
+    
+    for ( unsigned int r = 0; r < adj.size(); r++ )
+    {
+        if ( color[r] != -1 ) continue;
+        
+        color[r] = 0;
+        stack.push_back( r );
+        while ( !stack.empty() )
+        {
+            int x = stack.back();
+            stack.pop_back();
+            
+            for ( unsigned int i = 0; i < adj[x].size(); i++ )
+            {
+                int y = adj[x][i];
+                
+                if ( color[y] == color[x] ) return false;
+                if ( color[y] != -1 ) continue;
+                
+                color[y] = 1 - color[x];
+                stack.push_back( y );
+            }
+        }
+    }
+    
+    return true;
+}
+
+/*=============================================================================
+Function: greedy_matching
+Description: Warm start for the exact engines: vertices are taken by
+             increasing degree and each free one is matched to its free
+             neighbour of lowest degree. Returns the matching size.
+Parameters: adj - neighbours of each vertex
+            match - receives the partner of each vertex, or -1
+=============================================================================*/
+int greedy_matching( const vector< vector< int > > &adj, 
+                     vector< int > &match )
+{
+    vector< pair< int, int > > order;   // (degree, vertex)
+    int size = 0;                       // Edges matched
+    
+    match.assign( adj.size(), -1 );
+    for ( unsigned int x = 0; x < adj.size(); x++ )
+        order.push_back( make_pair( (int)adj[x].size(), x ) );
+    sort( order.begin(), order.end() );
+    
+    for ( unsigned int k = 0; k < order.size(); k++ )
+    {
+        int x = order[k].second;
+        int partner = -1;
+        
+        if ( match[x] != -1 ) continue;
+        
+        for ( unsigned int i = 0; i < adj[x].size(); i++ )
+        {
+            int y = adj[x][i];
+            
+            if ( match[y] == -1 && ( partner == -1 || 
+                 adj[y].size() < adj[partner].size() ) )
+                partner = y;
+        }
+        
+        if ( partner != -1 )
+        {
+            match[x] = partner;
+            match[partner] = x;
+            size++;
+        }
+    }
+    
+    return size;
+}
+
+/*=============================================================================
+Function: hopcroft_karp
+Description: Hopcroft-Karp bipartite matching, O(|E| sqrt|V|). Each phase
+             finds the shortest augmenting path length by a breadth first
+             search from the free vertices of side 0, then augments along
+             a maximal set of disjoint paths of that length.
+             Returns the matching size.
+Parameters: adj - neighbours of each vertex
+            color - side of each vertex
+            match - partner of each vertex, or -1; improved in place
+            phases - receives the number of phases
+=============================================================================*/
+int hopcroft_karp( const vector< vector< int > > &adj, 
+                   const vector< int > &color, vector< int > &match,
+                   int &phases )
+{
+    vector< int > dist;     // Layer of each side 0 vertex
+    int freeDist;           // Layer at which a free vertex is reached
+    int size = 0;           // Edges matched
+    
+    for ( unsigned int x = 0; x < adj.size(); x++ )
+        if ( match[x] != -1 && color[x] == 0 ) size++;
+    
+    phases = 0;
+    while ( hopcroft_karp_levels( adj, color, match, dist, freeDist ) )
+    {
+        phases++;
+        for ( unsigned int x = 0; x < adj.size(); x++ )
+        {
+            if ( color[x] == 0 && match[x] == -1 &&
+                 hopcroft_karp_augment( adj, match, dist, freeDist, x ) )
+                size++;
+        }
+    }
+    
+    return size;
+}
+
+/*=============================================================================
+Function: hopcroft_karp_levels
+Description: Layers the side 0 vertices by alternating distance from the
+             free ones. Returns true if a free side 1 vertex is reachable.
+Parameters: adj - neighbours of each vertex
+            color - side of each vertex
+            match - partner of each vertex, or -1
+            dist - receives the layer of each side 0 vertex
+            freeDist - receives the layer past the last useful one
+=============================================================================*/
+bool hopcroft_karp_levels( const vector< vector< int > > &adj, 
+                           const vector< int > &color, 
+                           const vector< int > &match, vector< int > &dist,
+                           int &freeDist )
+{
+    const int FAR = numeric_limits< int >::max();
+    vector< int > order;    // Side 0 vertices in breadth first order
+    
+    dist.assign( adj.size(), FAR );
+    freeDist = FAR;
+    
+    for ( unsigned int x = 0; x < adj.size(); x++ )
+    {
+        if ( color[x] == 0 && match[x] == -1 )
+        {
+            dist[x] = 0;
+            order.push_back( x );
+        }
+    }
+    
+    for ( unsigned int i = 0; i < order.size(); i++ )
+    {
+        int x = order[i];
+        
+        if ( dist[x] >= freeDist ) continue;
+        
+        for ( unsigned int k = 0; k < adj[x].size(); k++ )
+        {
+            int m = match[ adj[x][k] ];
+            
+            if ( m == -1 )
+            {
+                if ( freeDist == FAR ) freeDist = dist[x] + 1;
+            }
+            else if ( dist[m] == FAR )
+            {
+                dist[m] = dist[x] + 1;
+                order.push_back( m );
+            }
+        }
+    }
+    
+    return freeDist != FAR;
+}
+
+/*=============================================================================
+Function: hopcroft_karp_augment
+Description: Depth first search for a shortest augmenting path from x along
+             the layers, flipping it if found. Dead ends are cut from the
+             layers so each vertex is tried once per phase.
+Parameters: adj - neighbours of each vertex
+            match - partner of each vertex, or -1
+            dist - layer of each side 0 vertex
+            freeDist - layer at which free vertices are reached
+            x - side 0 vertex to start from
+=============================================================================*/
+bool hopcroft_karp_augment( const vector< vector< int > > &adj, 
+                            vector< int > &match, vector< int > &dist,
+                            int freeDist, int x )
+{
+    for ( unsigned int k = 0; k < adj[x].size(); k++ )
+    {
+        int y = adj[x][k];
+        int m = match[y];
+        
+        if ( m == -1 ? dist[x] + 1 == freeDist 
+                     : dist[m] == dist[x] + 1 && 
+                       hopcroft_karp_augment( adj, match, dist, freeDist, m ) )
+        {
+            match[x] = y;
+            match[y] = x;
+            return true;
+        }
+    }
+    
+    dist[x] = numeric_limits< int >::max();
+    return false;
+}
+
+/*=============================================================================
+Function: blossom_matching
+Description: Edmonds' blossom algorithm, O(|V|^3). From each free vertex an
+             alternating tree is grown breadth first; an edge between two
+             outer vertices closes an odd cycle (blossom), which is shrunk
+             into its base; reaching a free vertex gives an augmenting path
+             that is flipped. Returns the matching size.
+Parameters: search - graph and starting matching; match is improved in place
+            augmentations - receives the number of paths flipped
+=============================================================================*/
+int blossom_matching( BlossomSearch &search, int &augmentations )
+{
+    int n = search.adj.size();
+    int size = 0;           // Edges matched
+    
+    for ( int x = 0; x < n; x++ )
+        if ( search.match[x] > x ) size++;
+    
+    augmentations = 0;
+    for ( int root = 0; root < n; root++ )
+    {
+        if ( search.match[root] != -1 ) continue;
+        
+        int v = blossom_path( search, root );
+        if ( v == -1 ) continue;
+        
+        /** Flip the path ending at v **/
+        while ( v != -1 )
+        {
+            int pv = search.parent[v];
+            int next = search.match[pv];
+            
+            search.match[v] = pv;
+            search.match[pv] = v;
+            v = next;
+        }
+        augmentations++;
+        size++;
+    }
+    
+    return size;
+}
+
+/*=============================================================================
+Function: blossom_path
+Description: Grows an alternating tree from root, shrinking blossoms.
+             Returns the free vertex ending an augmenting path (its path is
+             held in parent and match), or -1 if there is none.
+Parameters: search - graph, matching and scratch space
+            root - free vertex to start from
+=============================================================================*/
+int blossom_path( BlossomSearch &search, int root )
+{
+    int n = search.adj.size();
+    
+    search.used.assign( n, 0 );
+    search.parent.assign( n, -1 );
+    search.base.resize( n );
+    for ( int x = 0; x < n; x++ ) search.base[x] = x;
+    
+    search.used[root] = 1;
+    search.queue.assign( 1, root );
+    
+    for ( unsigned int head = 0; head < search.queue.size(); head++ )
+    {
+        int v = search.queue[head];
+        
+        for ( unsigned int i = 0; i < search.adj[v].size(); i++ )
+        {
+            int to = search.adj[v][i];
+            
+            if ( search.base[v] == search.base[to] || 
+                 search.match[v] == to )
+                continue;
+            
+            /** Odd cycle: shrink the blossom into its base **/
+            if ( to == root || ( search.match[to] != -1 && 
+                 search.parent[ search.match[to] ] != -1 ) )
+            {
+                int b = blossom_lca( search, v, to );
+                
+                search.inBlossom.assign( n, 0 );
+                blossom_mark( search, v, b, to );
+                blossom_mark( search, to, b, v );
+                
+                for ( int x = 0; x < n; x++ )
+                {
+                    if ( !search.inBlossom[ search.base[x] ] ) continue;
+                    
+                    search.base[x] = b;
+                    if ( !search.used[x] )
+                    {
+                        search.used[x] = 1;
+                        search.queue.push_back( x );
+                    }
+                }
+            }
+            /** Grow the tree by an edge and its matched edge **/
+            else if ( search.parent[to] == -1 )
+            {
+                search.parent[to] = v;
+                if ( search.match[to] == -1 ) return to;
+                
+                search.used[ search.match[to] ] = 1;
+                search.queue.push_back( search.match[to] );
+            }
+        }
+    }
+    
+    return -1;
+}
+
+/*=============================================================================
+Function: blossom_lca
+Description: Returns the base of the nearest common ancestor of a and b in
+             the alternating tree
+Parameters: search - alternating tree
+            a, b - outer vertices
+=============================================================================*/
+int blossom_lca( BlossomSearch &search, int a, int b )
+{
+    vector< char > onPath( search.adj.size(), 0 );  // Bases above a
+    
+    while ( true )
+    {
+        a = search.base[a];
+        onPath[a] = 1;
+        if ( search.match[a] == -1 ) break;
+        a = search.parent[ search.match[a] ];
+    }
+    
+    while ( true )
+    {
+        b = search.base[b];
+        if ( onPath[b] ) return b;
+        b = search.parent[ search.match[b] ];
+    }
+}
+
+/*=============================================================================
+Function: blossom_mark
+Description: Walks from v up to the blossom base b, marking the bases passed
+             and pointing the inner vertices back across the new blossom
+Parameters: search - alternating tree
+            v - outer vertex on the blossom
+            b - base of the blossom
+            child - vertex across the closing edge from v
+=============================================================================*/
+void blossom_mark( BlossomSearch &search, int v, int b, int child )
+{
+    while ( search.base[v] != b )
+    {
+        search.inBlossom[ search.base[v] ] = 1;
+        search.inBlossom[ search.base[ search.match[v] ] ] = 1;
+        search.parent[v] = child;
+        child = search.match[v];
+        v = search.parent[ search.match[v] ];
+    }
+}
+
+/*=============================================================================
+Function: failure_points
+Description: Lists the single points of failure of input.txt: bridges
+             (edges whose removal disconnects their component) and
+             articulation points (vertices whose removal does), then the
+             biconnected component of every edge
+=============================================================================*/
+void failure_points()
+{
+    unsigned int vertexCount = 0;       // Stores vertex count from input file
+    int componentCount;                 // Number of biconnected components
+    vector< WeightedEdge > G;           // Our graph
+    vector< WeightedEdge > B;           // Bridges of G
+    vector< vector< int > > adj;        // Incident edges of each vertex
+    vector< char > bridge;              // Marks bridges
+    vector< char > cutVertex;           // Marks articulation points
+    vector< int > component;            // Biconnected component of each edge
+    
+    if ( !load_graph( G, vertexCount ) ) return;
+    
+    build_adjacency( G, vertexCount, adj );
+    componentCount = biconnected_components( G, adj, bridge, cutVertex, 
+                                             component );
+    
+    for ( unsigned int i = 0; i < G.size(); i++ )
+        if ( bridge[i] ) B.push_back( G[i] );
+    
+    /** Print the failure points **/
+    cout << endl << "Articulation points of G:" << endl << "  ";
+    for ( unsigned int x = 0; x < vertexCount; x++ )
+        if ( cutVertex[x] ) cout << " " << x;
+    cout << endl << endl;
+    
+    cout << "Bridges of G:" << endl;
+    print_graph(B);
+    
+    cout << "Biconnected component of each edge of G:" << endl;
+    for ( unsigned int i = 0; i < G.size(); i++ )
+    {
+        if ( component[i] < 0 ) continue;
+        
+        cout << "   Edge " << i << ": ";
+        G[i].print_edge();
+        cout << " in component " << component[i] << endl;
+    }
+    cout << endl;
+    
+    cout << "Number of biconnected components: " << endl 
+         << "   " << componentCount << endl << endl;
+}
+
+/*=============================================================================
+Function: biconnected_components
+Description: Tarjan-Hopcroft depth first search in O(|V| + |E|), with an
+             explicit stack instead of recursion so long paths cannot
+             overflow the call stack. low[x] is the earliest discovery time
+             reachable from the subtree of x by one back edge; when a child
+             y of p has low[y] >= disc[p], p separates y's subtree and the
+             edges stacked since the tree edge p-y form one biconnected
+             component (a bridge if low[y] > disc[p]).
+             Returns the number of biconnected components.
+Parameters: G - weighted edges stored as UVW vector set
+            adj - incident edge indices of each vertex
+            bridge - receives a mark on each bridge
+            cutVertex - receives a mark on each articulation point
+            component - receives the biconnected component of each edge
+                        (-1 for self loops)
+=============================================================================*/
+int biconnected_components( const vector< WeightedEdge > &G, 
+                            const vector< vector< int > > &adj,
+                            vector< char > &bridge, vector< char > &cutVertex,
+                            vector< int > &component )
+{
+    int n = adj.size();
+    vector< int > disc( n, -1 );        // Discovery time of each vertex
+    vector< int > low( n );             // Earliest time reachable below it
+    vector< int > parentEdge( n, -1 );  // Tree edge into each vertex
+    vector< unsigned int > cursor( n, 0 );
+                                        // Next incident edge to look at
+    vector< int > path;                 // Vertices of the search path
+    vector< int > edges;                // Edges not yet in a component
+    int time = 0;                       // Discovery clock
+    int count = 0;                      // Components found
+    
+    bridge.assign( G.size(), 0 );
+    cutVertex.assign( n, 0 );
+    component.assign( G.size(), -1 );
+    
+    for ( int r = 0; r < n; r++ )
+    {
+        int rootChildren = 0;           // Tree edges out of the root
+        
+        if ( disc[r] != -1 ) continue;
+        
+        disc[r] = low[r] = time++;
+        path.push_back( r );
+        
+        while ( !path.empty() )
+        {
+            int x = path.back();
+            
+            /** Look at the next edge of x **/
+            if ( cursor[x] < adj[x].size() )
+            {
+                int e = adj[x][ cursor[x]++ ];
+                int y = ( G[e].getU() == x ) ? G[e].getV() : G[e].getU();
+                
+                if ( e == parentEdge[x] ) continue;
+                
+                if ( disc[y] == -1 )
+                {
+                    edges.push_back( e );
+                    disc[y] = low[y] = time++;
+                    parentEdge[y] = e;
+                    path.push_back( y );
+                    if ( x == r ) rootChildren++;
+                }
+                else if ( disc[y] < disc[x] )
+                {
+                    edges.push_back( e );
+                    low[x] = min( low[x], disc[y] );
+                }
+                continue;
+            }
+            
+            /** x is finished: report to its parent **/
+            path.pop_back();
+            if ( path.empty() ) break;
+            
+            int p = path.back();
+            low[p] = min( low[p], low[x] );
+            
+            if ( low[x] >= disc[p] )
+            {
+                int e;
+                
+                if ( p != r ) cutVertex[p] = 1;
+                if ( low[x] > disc[p] ) bridge[ parentEdge[x] ] = 1;
+                
+                do
+                {
+                    e = edges.back();
+                    edges.pop_back();
+                    component[e] = count;
+                } while ( e != parentEdge[x] );
+                count++;
+            }
+        }
+        
+        if ( rootChildren >= 2 ) cutVertex[r] = 1;
+    }
+    
+    return count;
+}
+
+/*=============================================================================
+Function: travelling_salesman
+Description: Builds a short round trip through every city of points.txt
+             (Euclidean) or input.txt (a complete weight matrix) from the
+             minimum spanning tree: the double-tree tour (tree preorder) or
+             Christofides' tour (tree plus a pairing of its odd vertices,
+             shortcut Euler circuit). The tour can then be improved with
+             2-opt and Or-opt moves. The tour is written to tour.txt.
+=============================================================================*/
+void travelling_salesman()
+{
+    int source;                         // 1 points.txt, 2 input.txt
+    int construction;                   // 1 double tree, 2 Christofides
+    int improve;                        // Whether to run local search
+    unsigned int cityCount = 0;         // Number of cities
+    double treeLength = 0;              // Length of the spanning tree
+    PointCloud P;                       // Cities read from points.txt
+    vector< WeightedEdge > G;           // Cities read from input.txt
+    vector< vector< int > > M;          // Weight matrix of G
+    TourMetric metric = { NULL, NULL }; // Distances between cities
+    vector< pair< int, int > > treeEdges;
+                                        // Edges of the spanning tree
+    vector< int > tour;                 // Cities in visiting order
+    ofstream outfile;                   // Stores output file data for tour
+    
+    do
+    {
+        printf(" Read the cities from?\n");
+        printf(" 1: points.txt\n");
+        printf(" 2: input.txt\n");
+        printf(" > ");
+        cin >> source;
+    } while ( !(source == 1 || source == 2) );
+    
+    /** Cities and their spanning tree **/
+    if ( source == 1 )
+    {
+        vector< GeometricEdge > T;      // Euclidean spanning tree
+        
+        if ( !read_points( P ) ) return;
+        metric.points = &P;
+        cityCount = P.count;
+        
+        treeLength = euclidean_mst( P, T );
+        for ( unsigned int i = 0; i < T.size(); i++ )
+            treeEdges.push_back( make_pair( T[i].u, T[i].v ) );
+    }
+    else
+    {
+        vector< int > treeIndex;        // Indices in G of the tree edges
+        unsigned int pairs = 0;         // Edges between distinct cities
+        
+        if ( !load_graph( G, cityCount ) ) return;
+        for ( unsigned int i = 0; i < G.size(); i++ )
+            if ( G[i].getU() != G[i].getV() ) pairs++;
+        
+        if ( pairs != cityCount * ( cityCount - 1 ) / 2 )
+        {
+            cout << "input.txt must give a weight for every pair of cities." 
+                 << endl << endl;
+            return;
+        }
+        
+        graph_to_matrix( G, cityCount, M );
+        metric.matrix = &M;
+        
+        treeLength = prim_tree( G, cityCount, treeIndex );
+        for ( unsigned int i = 0; i < treeIndex.size(); i++ )
+            treeEdges.push_back( make_pair( G[ treeIndex[i] ].getU(), 
+                                            G[ treeIndex[i] ].getV() ) );
+    }
+    
+    do
+    {
+        printf(" Which construction?\n");
+        printf(" 1: Double tree\n");
+        printf(" 2: Christofides (greedy pairing)\n");
+        printf(" > ");
+        cin >> construction;
+    } while ( !(construction == 1 || construction == 2) );
+    
+    do
+    {
+        printf(" Improve with 2-opt and Or-opt? (1 yes, 0 no)\n");
+        printf(" > ");
+        cin >> improve;
+    } while ( !(improve == 0 || improve == 1) );
+    cout << endl;
+    
+    /** Build the tour **/
+    if ( construction == 1 )
+        preorder_tour( cityCount, treeEdges, tour );
+    else
+        christofides_tour( metric, cityCount, treeEdges, tour );
+    
+    cout << "Length of the minimum spanning tree: " << treeLength << endl;
+    cout << "Tour length after construction: " << tour_length( metric, tour )
+         << endl;
+    
+    /** Local search **/
+    if ( improve )
+    {
+        const unsigned int K = 10;      // Neighbours tried per city
+        vector< vector< int > > near;   // Nearest cities of each city
+        vector< int > all( cityCount ); // Every city
+        long long moves;                // Improving moves made
+        
+        for ( unsigned int x = 0; x < cityCount; x++ ) all[x] = x;
+        city_neighbors( metric, all, K, near );
+        moves = improve_tour( metric, near, tour );
+        
+        cout << "Tour length after " << moves << " improving moves: " 
+             << tour_length( metric, tour ) << endl;
+    }
+    
+    outfile.open( "tour.txt" );
+    outfile << cityCount << endl;
+    for ( unsigned int i = 0; i < tour.size(); i++ )
+        outfile << tour[i] << endl;
+    outfile.close();
+    
+    cout << "Tour written to tour.txt" << endl << endl;
+}
+
+/*=============================================================================
+Function: TourMetric::distance
+Description: Returns the distance between two cities
+Parameters: a, b - cities
+=============================================================================*/
+double TourMetric::distance( int a, int b ) const
+{
+    if ( matrix != NULL ) return (*matrix)[a][b];
+    
+    const int D = points->dimension;
+    double sum = 0;
+    
+    for ( int k = 0; k < D; k++ )
+    {
+        double d = points->coord[ (size_t)a*D + k ] 
+                 - points->coord[ (size_t)b*D + k ];
+        sum += d * d;
+    }
+    return sqrt( sum );
+}
+
+/*=============================================================================
+Function: city_neighbors
+Description: Lists for each city of a subset its k nearest cities in the
+             same subset, nearest first. Points use a kd-tree over the
+             subset, queried in parallel; matrix rows are sorted.
+Parameters: metric - distances between cities
+            cities - the subset
+            k - neighbours per city
+            near - receives near[i], the neighbours of cities[i]
+=============================================================================*/
+void city_neighbors( const TourMetric &metric, const vector< int > &cities,
+                     unsigned int k, vector< vector< int > > &near )
+{
+    int count = cities.size();
+    
+    near.assign( count, vector< int >() );
+    k = min( k, (unsigned int)max( count - 1, 0 ) );
+    
+    if ( metric.points != NULL )
+    {
+        const int D = metric.points->dimension;
+        PointCloud Q;                   // The subset as its own cloud
+        
+        Q.count = count;
+        Q.dimension = D;
+        Q.coord.resize( (size_t)count * D );
+        for ( int i = 0; i < count; i++ )
+            for ( int j = 0; j < D; j++ )
+                Q.coord[ (size_t)i*D + j ] = 
+                    metric.points->coord[ (size_t)cities[i]*D + j ];
+        
+        KdTree tree( Q );
+        
+        #pragma omp parallel for schedule(dynamic, 256)
+        for ( int i = 0; i < count; i++ )
+        {
+            tree.nearest( i, k, near[i] );
+            for ( unsigned int j = 0; j < near[i].size(); j++ )
+                near[i][j] = cities[ near[i][j] ];
+        }
+        return;
+    }
+    
+    #pragma omp parallel for schedule(dynamic, 16)
+    for ( int i = 0; i < count; i++ )
+    {
+        vector< pair< double, int > > others;   // (distance, city)
+        
+        for ( int j = 0; j < count; j++ )
+        {
+            if ( j == i ) continue;
+            others.push_back( make_pair( metric.distance( cities[i], 
+                                                          cities[j] ), 
+                                         cities[j] ) );
+        }
+        partial_sort( others.begin(), others.begin() + k, others.end() );
+        for ( unsigned int j = 0; j < k; j++ )
+            near[i].push_back( others[j].second );
+    }
+}
+
+/*=============================================================================
+Function: preorder_tour
+Description: Double-tree tour: the cities in depth first preorder of the
+             spanning tree, which shortcuts the walk around the doubled tree
+             (at most twice the optimum for metric distances)
+Parameters: cityCount - number of cities
+            treeEdges - edges of the spanning tree
+            tour - receives the cities in visiting order
+=============================================================================*/
+void preorder_tour( unsigned int cityCount, 
+                    const vector< pair< int, int > > &treeEdges,
+                    vector< int > &tour )
+{
+    vector< vector< int > > adj( cityCount );   // Tree neighbours
+    vector< char > seen( cityCount, 0 );        // Marks visited cities
+    vector< int > stack( 1, 0 );                // Cities left to visit
+    
+    for ( unsigned int i = 0; i < treeEdges.size(); i++ )
+    {
+        adj[ treeEdges[i].first ].push_back( treeEdges[i].second );
+        adj[ treeEdges[i].second ].push_back( treeEdges[i].first );
+    }
+    
+    tour.clear();
+    while ( !stack.empty() )
+    {
+        int x = stack.back();
+        stack.pop_back();
+        
+        if ( seen[x] ) continue;
+        seen[x] = 1;
+        tour.push_back( x );
+        
+        for ( int i = adj[x].size() - 1; i >= 0; i-- )
+            if ( !seen[ adj[x][i] ] ) stack.push_back( adj[x][i] );
+    }
+}
+
+/*=============================================================================
+Function: christofides_tour
+Description: Christofides' construction: the spanning tree plus a pairing
+             of its odd-degree vertices has only even degrees, so it has an
+             Euler circuit, which is shortcut to a tour. The pairing is
+             greedy rather than a minimum weight perfect matching, so the
+             3/2 guarantee does not hold, but tours stay well below the
+             double tree in practice.
+Parameters: metric - distances between cities
+            cityCount - number of cities
+            treeEdges - edges of the spanning tree
+            tour - receives the cities in visiting order
+=============================================================================*/
+void christofides_tour( const TourMetric &metric, unsigned int cityCount,
+                        const vector< pair< int, int > > &treeEdges,
+                        vector< int > &tour )
+{
+    vector< int > degree( cityCount, 0 );       // Tree degree of each city
+    vector< int > odd;                          // Cities of odd degree
+    vector< pair< int, int > > edges;           // Tree plus pairing
+    vector< vector< int > > adj( cityCount );   // Incident edges per city
+    vector< unsigned int > cursor( cityCount, 0 );
+                                                // Next edge to try per city
+    vector< char > used;                        // Marks walked edges
+    vector< char > seen( cityCount, 0 );        // Marks visited cities
+    vector< int > stack( 1, 0 );                // Open part of the circuit
+    
+    for ( unsigned int i = 0; i < treeEdges.size(); i++ )
+    {
+        degree[ treeEdges[i].first ]++;
+        degree[ treeEdges[i].second ]++;
+    }
+    for ( unsigned int x = 0; x < cityCount; x++ )
+        if ( degree[x] % 2 ) odd.push_back( x );
+    
+    greedy_pairing( metric, odd, edges );
+    edges.insert( edges.end(), treeEdges.begin(), treeEdges.end() );
+    
+    used.assign( edges.size(), 0 );
+    for ( unsigned int i = 0; i < edges.size(); i++ )
+    {
+        adj[ edges[i].first ].push_back( i );
+        adj[ edges[i].second ].push_back( i );
+    }
+    
+    /** Hierholzer's circuit, shortcut as cities leave the stack **/
+    tour.clear();
+    while ( !stack.empty() )
+    {
+        int x = stack.back();
+        
+        while ( cursor[x] < adj[x].size() && used[ adj[x][ cursor[x] ] ] )
+            cursor[x]++;
+        
+        if ( cursor[x] == adj[x].size() )
+        {
+            stack.pop_back();
+            if ( !seen[x] )
+            {
+                seen[x] = 1;
+                tour.push_back( x );
+            }
+            continue;
+        }
+        
+        int e = adj[x][ cursor[x] ];
+        used[e] = 1;
+        stack.push_back( edges[e].first == x ? edges[e].second 
+                                             : edges[e].first );
+    }
+}
+
+/*=============================================================================
+Function: greedy_pairing
+Description: Pairs up an even number of cities, shortest candidate pair
+             first. Small sets try every pair; large ones try each city's
+             8 nearest remaining cities, then repeat on whatever is left.
+Parameters: metric - distances between cities
+            odd - cities to pair
+            pairs - receives the pairs
+=============================================================================*/
+void greedy_pairing( const TourMetric &metric, const vector< int > &odd,
+                     vector< pair< int, int > > &pairs )
+{
+    vector< int > left = odd;               // Cities still unpaired
+    vector< char > paired;                  // Marks cities paired so far
+    
+    pairs.clear();
+    while ( left.size() >= 2 )
+    {
+        vector< pair< double, pair< int, int > > > candidates;
+                                            // (distance, (city, city))
+        vector< int > rest;                 // Cities left after this round
+        
+        if ( left.size() <= 2048 )
+        {
+            for ( unsigned int i = 0; i < left.size(); i++ )
+                for ( unsigned int j = i + 1; j < left.size(); j++ )
+                    candidates.push_back( make_pair( 
+                        metric.distance( left[i], left[j] ), 
+                        make_pair( left[i], left[j] ) ) );
+        }
+        else
+        {
+            vector< vector< int > > near;   // Nearest remaining cities
+            
+            city_neighbors( metric, left, 8, near );
+            for ( unsigned int i = 0; i < left.size(); i++ )
+                for ( unsigned int j = 0; j < near[i].size(); j++ )
+                    candidates.push_back( make_pair( 
+                        metric.distance( left[i], near[i][j] ), 
+                        make_pair( left[i], near[i][j] ) ) );
+        }
+        sort( candidates.begin(), candidates.end() );
+        
+        paired.assign( metric.points ? metric.points->count 
+                                     : metric.matrix->size(), 0 );
+        for ( unsigned int i = 0; i < candidates.size(); i++ )
+        {
+            int a = candidates[i].second.first;
+            int b = candidates[i].second.second;
+            
+            if ( paired[a] || paired[b] ) continue;
+            paired[a] = paired[b] = 1;
+            pairs.push_back( make_pair( a, b ) );
+        }
+        
+        for ( unsigned int i = 0; i < left.size(); i++ )
+            if ( !paired[ left[i] ] ) rest.push_back( left[i] );
+        left.swap( rest );
+    }
+}
+
+/*=============================================================================
+Function: tour_length
+Description: Returns the length of the closed tour
+Parameters: metric - distances between cities
+            tour - cities in visiting order
+=============================================================================*/
+double tour_length( const TourMetric &metric, const vector< int > &tour )
+{
+    double length = 0;
+    
+    for ( unsigned int i = 0; i < tour.size(); i++ )
+        length += metric.distance( tour[i], tour[ ( i + 1 ) % tour.size() ] );
+    
+    return length;
+}
+
+/*=============================================================================
+Function: improve_tour
+Description: Local search with neighbour lists and a queue of cities to
+             look at (don't-look bits). For a city a, 2-opt tries to
+             replace the tour edge at a and another edge by two shorter
+             ones through one of a's near cities; Or-opt tries to move the
+             segment of 1 to 3 cities starting at a between two adjacent
+             cities near its ends, either way round. The cities touched by
+             an improving move are queued again. Returns the number of
+             improving moves.
+Parameters: metric - distances between cities
+            near - nearest cities of each city, nearest first
+            tour - cities in visiting order, improved in place
+=============================================================================*/
+long long improve_tour( const TourMetric &metric, 
+                        const vector< vector< int > > &near, 
+                        vector< int > &tour )
+{
+    const double EPS = 1e-9;                // Smallest gain that counts
+    int n = tour.size();
+    vector< int > pos( n );                 // Place of each city in tour
+    vector< int > queue( tour );            // Cities to look at
+    vector< char > queued( n, 1 );          // Marks cities in the queue
+    long long moves = 0;                    // Improving moves made
+    
+    if ( n < 5 ) return 0;
+    for ( int i = 0; i < n; i++ ) pos[ tour[i] ] = i;
+    
+    for ( unsigned int head = 0; head < queue.size(); head++ )
+    {
+        int a = queue[head];
+        int touched[6];                     // Cities of the move made
+        int touchedCount = 0;
+        
+        queued[a] = 0;
+        
+        /** 2-opt, with a's successor and with its predecessor **/
+        for ( int dir = 1; dir >= -1 && !touchedCount; dir -= 2 )
+        {
+            int b = tour[ ( pos[a] + dir + n ) % n ];
+            double dab = metric.distance( a, b );
+            
+            for ( unsigned int i = 0; i < near[a].size(); i++ )
+            {
+                int c = near[a][i];
+                double g1 = dab - metric.distance( a, c );
+                
+                if ( g1 <= EPS ) break;
+                
+                int d = tour[ ( pos[c] + dir + n ) % n ];
+                if ( d == a || c == b ) continue;
+                
+                if ( g1 + metric.distance( c, d ) - metric.distance( b, d ) 
+                     > EPS )
+                {
+                    two_opt_move( tour, pos, a, b, c, d );
+                    touched[0] = a; touched[1] = b;
+                    touched[2] = c; touched[3] = d;
+                    touchedCount = 4;
+                    break;
+                }
+            }
+        }
+        
+        /** Or-opt on the segment starting at a **/
+        for ( int L = 1; L <= 3 && !touchedCount && n >= L + 3; L++ )
+        {
+            int s1 = a;
+            int s2 = tour[ ( pos[a] + L - 1 ) % n ];
+            int p = tour[ ( pos[s1] - 1 + n ) % n ];
+            int nx = tour[ ( pos[s2] + 1 ) % n ];
+            double removal = metric.distance( p, s1 ) 
+                           + metric.distance( s2, nx ) 
+                           - metric.distance( p, nx );
+            
+            if ( removal <= EPS ) continue;
+            
+            for ( int end = 0; end < 2 && !touchedCount; end++ )
+            {
+                int e = end ? s2 : s1;
+                
+                for ( unsigned int i = 0; i < near[e].size() && 
+                      !touchedCount; i++ )
+                {
+                    int c = near[e][i];
+                    
+                    if ( metric.distance( e, c ) >= removal ) break;
+                    if ( ( pos[c] - pos[s1] + n ) % n < L ) continue;
+                    
+                    // Slots after c and before c
+                    for ( int slot = 0; slot < 2; slot++ )
+                    {
+                        int u = slot ? tour[ ( pos[c] - 1 + n ) % n ] : c;
+                        int v = tour[ ( pos[u] + 1 ) % n ];
+                        
+                        if ( ( pos[u] - pos[s1] + n ) % n < L || 
+                             ( pos[v] - pos[s1] + n ) % n < L )
+                            continue;
+                        
+                        double uv = metric.distance( u, v );
+                        double ahead = metric.distance( u, s1 ) 
+                                     + metric.distance( s2, v ) - uv;
+                        double back = metric.distance( u, s2 ) 
+                                    + metric.distance( s1, v ) - uv;
+                        
+                        if ( removal - min( ahead, back ) <= EPS ) continue;
+                        
+                        // Three 2-opt moves: cut out, reinsert reversed,
+                        // then turn the segment round if that is shorter
+                        two_opt_move( tour, pos, p, s1, u, v );
+                        two_opt_move( tour, pos, p, u, nx, s2 );
+                        if ( L > 1 && ahead < back )
+                            two_opt_move( tour, pos, u, s2, s1, v );
+                        
+                        touched[0] = p; touched[1] = nx;
+                        touched[2] = u; touched[3] = v;
+                        touched[4] = s1; touched[5] = s2;
+                        touchedCount = 6;
+                        break;
+                    }
+                }
+            }
+        }
+        
+        /** Look at the cities of the move again **/
+        if ( touchedCount ) moves++;
+        for ( int i = 0; i < touchedCount; i++ )
+        {
+            if ( queued[ touched[i] ] ) continue;
+            queued[ touched[i] ] = 1;
+            queue.push_back( touched[i] );
+        }
+        
+        // Drop the processed part of the queue now and then
+        if ( head > (unsigned int)n && head * 2 > queue.size() )
+        {
+            queue.erase( queue.begin(), queue.begin() + head + 1 );
+            head = -1;
+        }
+    }
+    
+    return moves;
+}
+
+/*=============================================================================
+Function: two_opt_move
+Description: Replaces the tour edges a-b and c-d by a-c and b-d, where
+             walking the tour from a through b reaches c and then d
+             (in either direction of the array)
+Parameters: tour - cities in visiting order
+            pos - place of each city in tour
+            a, b, c, d - the cities of the two edges
+=============================================================================*/
+void two_opt_move( vector< int > &tour, vector< int > &pos, 
+                   int a, int b, int c, int d )
+{
+    int n = tour.size();
+    
+    (void)d;
+    if ( tour[ ( pos[a] + 1 ) % n ] == b )
+        reverse_tour( tour, pos, b, c );
+    else
+        reverse_tour( tour, pos, c, b );
+}
+
+/*=============================================================================
+Function: reverse_tour
+Description: Reverses the part of the tour running forward from city from
+             to city to. If that part is longer than half the tour the rest
+             is reversed instead, which gives the same cycle.
+Parameters: tour - cities in visiting order
+            pos - place of each city in tour
+            from, to - ends of the part
+=============================================================================*/
+void reverse_tour( vector< int > &tour, vector< int > &pos, 
+                   int from, int to )
+{
+    int n = tour.size();
+    int i = pos[from];
+    int j = pos[to];
+    int length = ( j - i + n ) % n + 1;
+    
+    if ( 2 * length > n )
+    {
+        int k = i;
+        i = ( j + 1 ) % n;
+        j = ( k - 1 + n ) % n;
+        length = n - length;
+    }
+    
+    for ( int k = 0; k < length / 2; k++ )
+    {
+        swap( tour[i], tour[j] );
+        pos[ tour[i] ] = i;
+        pos[ tour[j] ] = j;
+        i = ( i + 1 ) % n;
+        j = ( j - 1 + n ) % n;
+    }
+}
+
+/*=============================================================================
+Function: exact_tour
+Description: Finds a minimum weight Hamiltonian cycle of input.txt (up to
+             25 vertices) with the Held-Karp dynamic program, or decides
+             which graphs of generated_graphs.txt are Hamiltonian.
+             
+             The batch solves each isomorphism class once, with the classes
+             solved in parallel, and writes per-graph results to
+             hamiltonian_cycles.txt as
+                 graph  vertices  1 if Hamiltonian, else 0
+=============================================================================*/
+void exact_tour()
+{
+    const unsigned int MAX_VERTICES = 25;   // Held-Karp table limit
+    const int MAX_WEIGHT = 20000000;        // Keeps tour sums in an int
+    int source;                     // 1 for input.txt, 2 for the batch
+    
+    do
+    {
+        printf(" 1: Solve input.txt\n");
+        printf(" 2: Solve generated_graphs.txt\n");
+        printf(" > ");
+        cin >> source;
+    } while ( !(source == 1 || source == 2) );
+    cout << endl;
+    
+    if ( source == 1 )
+    {
+        unsigned int vertexCount = 0;   // Stores vertex count from input file
+        vector< WeightedEdge > G;       // Our graph
+        vector< vector< int > > M;      // G as a symmetric matrix
+        vector< int > tour;             // Vertices of the cycle in order
+        long long weight;               // Weight of the cycle
+        
+        if ( !load_graph( G, vertexCount ) ) return;
+        
+        if ( vertexCount > MAX_VERTICES )
+        {
+            cout << "Held-Karp is limited to " << MAX_VERTICES 
+                 << " vertices; input.txt has " << vertexCount << "." 
+                 << endl << endl;
+            return;
+        }
+        for ( unsigned int i = 0; i < G.size(); i++ )
+        {
+            if ( abs( G[i].getW() ) > MAX_WEIGHT )
+            {
+                cout << "Edge weights must lie within +-" << MAX_WEIGHT 
+                     << "." << endl << endl;
+                return;
+            }
+        }
+        
+        graph_to_matrix( G, vertexCount, M );
+        
+        if ( !held_karp( M, tour, weight ) )
+        {
+            cout << "G has no Hamiltonian cycle." << endl << endl;
+            return;
+        }
+        
+        cout << "Minimum weight Hamiltonian cycle: " << weight << endl 
+             << "  ";
+        for ( unsigned int i = 0; i < tour.size(); i++ ) 
+            cout << " " << tour[i];
+        cout << " " << tour[0] << endl << endl;
+        return;
+    }
+    
+    /** Group the batch into isomorphism classes **/
+    ifstream inputFile;                     // Stores generated graph data
+    ofstream outfile;                       // Stores per-graph results
+    vector< vector< int > > M;              // Current graph
+    map< GraphHash, int > classOf;          // Class index of each hash
+    vector< vector< vector< int > > > rep;  // First graph of each class
+    vector< int > graphClass;               // Class of each graph
+    
+    if ( !check_file( inputFile, "generated_graphs.txt" ) ) return;
+    
+    while ( read_generated_graph( inputFile, M ) )
+    {
+        if ( M.size() > MAX_VERTICES )
+        {
+            cout << "Held-Karp is limited to " << MAX_VERTICES 
+                 << " vertices; generated_graphs.txt has a graph with " 
+                 << M.size() << "." << endl << endl;
+            return;
+        }
+        
+        vector< int > label;
+        GraphHash h = canonical_hash( M, label );
+        
+        if ( classOf.find( h ) == classOf.end() )
+        {
+            classOf[h] = rep.size();
+            rep.push_back( M );
+        }
+        graphClass.push_back( classOf[h] );
+    }
+    inputFile.close();
+    
+    /** Solve each class once **/
+    vector< char > cyclic( rep.size() );
+    
+    #pragma omp parallel for schedule(dynamic)
+    for ( int c = 0; c < (int)rep.size(); c++ )
+        cyclic[c] = hamiltonian_cycle( rep[c] );
+    
+    /** Fan results out **/
+    map< int, pair< int, int > > tally;     // Vertices -> (graphs, cyclic)
+    
+    outfile.open( "hamiltonian_cycles.txt" );
+    for ( unsigned int i = 0; i < graphClass.size(); i++ )
+    {
+        int c = graphClass[i];
+        
+        outfile << i + 1 << " " << rep[c].size() << " " << (int)cyclic[c] 
+                << endl;
+        tally[ rep[c].size() ].first++;
+        tally[ rep[c].size() ].second += cyclic[c];
+    }
+    outfile.close();
+    
+    cout << "Hamiltonian graphs in generated_graphs.txt:" << endl;
+    for ( map< int, pair< int, int > >::iterator it = tally.begin(); 
+          it != tally.end(); ++it )
+    {
+        cout << "   " << it->first << " vertices: " << it->second.second 
+             << " of " << it->second.first << " graphs" << endl;
+    }
+    cout << endl << "Solved " << rep.size() << " classes for " 
+         << graphClass.size() << " graphs" << endl
+         << "Per-graph results written to hamiltonian_cycles.txt" 
+         << endl << endl;
+}
+
+/*=============================================================================
+Function: held_karp
+Description: Minimum weight Hamiltonian cycle by the Held-Karp dynamic
+             program. With vertex 0 as the start, D[S][j] is the lightest
+             path from 0 through the set S of other vertices ending at j in
+             S. Rows are stored subset-major, so a row is n-1 contiguous
+             ints and D[S][j] is a min-plus product of the row of S-{j}
+             with column j of the weights, which vectorizes: entries
+             outside S-{j} and missing edges hold INF, so no masking is
+             needed. Sets of one size only depend on the size below and are
+             filled in parallel.
+             
+             Weights are shifted to be positive (every cycle has n edges,
+             so the optimum is unchanged) and must keep n times the
+             largest shifted weight below INF. Returns false if there is
+             no Hamiltonian cycle.
+Parameters: M - symmetric weight matrix, 0 where there is no edge
+            tour - receives the vertices of the cycle from 0
+            weight - receives the weight of the cycle
+=============================================================================*/
+bool held_karp( const vector< vector< int > > &M, vector< int > &tour,
+                long long &weight )
+{
+    const int INF = 0x3fffffff;             // No path; INF + INF fits
+    int n = M.size();
+    int m = n - 1;                          // Vertices other than 0
+    int lightest = 0;                       // Smallest edge weight
+    
+    tour.clear();
+    if ( n < 3 ) return false;
+    
+    for ( int a = 0; a < n; a++ )
+        for ( int b = 0; b < n; b++ )
+            if ( a != b && M[a][b] != 0 ) lightest = min( lightest, M[a][b] );
+    
+    int shift = 1 - lightest;               // Added to every edge
+    size_t subsets = (size_t)1 << m;
+    vector< int > column( (size_t)m * m, INF );
+                                            // column[j*m+k]: edge k to j
+    vector< int > first( m, INF );          // Edge from 0 to each vertex
+    vector< int > D( subsets * m, INF );    // D[S*m+j] as above
+    vector< unsigned int > order( subsets );// Subsets by size
+    vector< size_t > layer( m + 2, 0 );     // Start of each size in order
+    
+    // Vertex j here is vertex j+1 of M
+    for ( int j = 0; j < m; j++ )
+    {
+        if ( M[0][j+1] != 0 ) first[j] = M[0][j+1] + shift;
+        for ( int k = 0; k < m; k++ )
+            if ( k != j && M[k+1][j+1] != 0 ) 
+                column[ (size_t)j*m + k ] = M[k+1][j+1] + shift;
+    }
+    
+    /** Counting sort of the subsets by size **/
+    for ( size_t S = 0; S < subsets; S++ ) 
+        layer[ __builtin_popcount( S ) + 1 ]++;
+    for ( int k = 1; k <= m + 1; k++ ) layer[k] += layer[k-1];
+    {
+        vector< size_t > fill( layer.begin(), layer.end() - 1 );
+        for ( size_t S = 0; S < subsets; S++ ) 
+            order[ fill[ __builtin_popcount( S ) ]++ ] = S;
+    }
+    
+    /** Fill the table one subset size at a time **/
+    for ( int j = 0; j < m; j++ ) D[ ( (size_t)1 << j ) * m + j ] = first[j];
+    
+    for ( int size = 2; size <= m; size++ )
+    {
+        long long from = layer[size];
+        long long to = layer[size+1];
+        
+        #pragma omp parallel for schedule(static)
+        for ( long long i = from; i < to; i++ )
+        {
+            size_t S = order[i];
+            int *row = &D[ S * m ];
+            
+            for ( int j = 0; j < m; j++ )
+            {
+                if ( !( S >> j & 1 ) ) continue;
+                
+                const int *prev = &D[ ( S ^ ( (size_t)1 << j ) ) * m ];
+                const int *col = &column[ (size_t)j * m ];
+                int best = INF;
+                
+                #pragma omp simd reduction(min:best)
+                for ( int k = 0; k < m; k++ )
+                    best = min( best, prev[k] + col[k] );
+                
+                row[j] = min( best, INF );
+            }
+        }
+    }
+    
+    /** Close the cycle and walk back through the table **/
+    size_t S = subsets - 1;
+    long long best = INF;
+    int end = -1;
+    
+    for ( int j = 0; j < m; j++ )
+    {
+        long long closed = (long long)D[ S * m + j ] + first[j];
+        if ( D[ S * m + j ] < INF && first[j] < INF && closed < best )
+        {
+            best = closed;
+            end = j;
+        }
+    }
+    if ( end < 0 ) return false;
+    
+    weight = best - (long long)n * shift;
+    
+    vector< int > path;                     // Vertices from the end back
+    while ( true )
+    {
+        path.push_back( end + 1 );
+        
+        size_t rest = S ^ ( (size_t)1 << end );
+        if ( rest == 0 ) break;
+        
+        for ( int k = 0; k < m; k++ )
+        {
+            if ( ( rest >> k & 1 ) && D[ rest * m + k ] < INF && 
+                 D[ rest * m + k ] + column[ (size_t)end * m + k ] == 
+                 D[ S * m + end ] )
+            {
+                end = k;
+                break;
+            }
+        }
+        S = rest;
+    }
+    
+    tour.push_back( 0 );
+    tour.insert( tour.end(), path.rbegin(), path.rend() );
+    return true;
+}
+
+/*=============================================================================
+Function: hamiltonian_cycle
+Description: Decides whether the graph has a Hamiltonian cycle. The Held-
+             Karp table shrinks to one word per subset: bit j of reach[S]
+             says some path from vertex 0 through S ends at j.
+Parameters: M - symmetric matrix, nonzero off the diagonal for edges
+=============================================================================*/
+bool hamiltonian_cycle( const vector< vector< int > > &M )
+{
+    int n = M.size();
+    int m = n - 1;                          // Vertices other than 0
+    
+    if ( n < 3 ) return false;
+    
+    size_t subsets = (size_t)1 << m;
+    vector< unsigned int > adj( m, 0 );     // Neighbours among 1..n-1
+    vector< unsigned int > reach( subsets, 0 );
+    unsigned int start = 0;                 // Neighbours of vertex 0
+    
+    // Vertex j here is vertex j+1 of M
+    for ( int j = 0; j < m; j++ )
+    {
+        if ( M[0][j+1] != 0 ) start |= 1u << j;
+        for ( int k = 0; k < m; k++ )
+            if ( k != j && M[j+1][k+1] != 0 ) adj[j] |= 1u << k;
+    }
+    
+    // S - {j} < S, so increasing order fills smaller sets first
+    for ( size_t S = 1; S < subsets; S++ )
+    {
+        if ( ( S & ( S - 1 ) ) == 0 )
+        {
+            reach[S] = S & start;
+            continue;
+        }
+        for ( int j = 0; j < m; j++ )
+        {
+            if ( ( S >> j & 1 ) && 
+                 ( reach[ S ^ ( (size_t)1 << j ) ] & adj[j] ) )
+                reach[S] |= 1u << j;
+        }
+    }
+    
+    return ( reach[ subsets - 1 ] & start ) != 0;
+}
+
+/*=============================================================================
+Function: graph_diameter
+Description: Computes the diameter of input.txt, the longest shortest path,
+             with a handful of searches instead of one per vertex: iFUB
+             with a 2-sweep start when weights are ignored, Takes-Kosters
+             eccentricity bounding with Dijkstra otherwise. With a search
+             budget the run stops early and reports bounds on the diameter.
+             If G is disconnected its largest component is measured.
+=============================================================================*/
+void graph_diameter()
+{
+    unsigned int vertexCount = 0;   // Stores vertex count from input file
+    vector< WeightedEdge > G;       // Our graph
+    vector< int > start;            // Adjacency offsets per vertex
+    vector< int > neighbor;         // Adjacent vertices
+    vector< int > weight;           // Weights of the adjacencies
+    int weighted;                   // Whether distances use edge weights
+    long long budget;               // Search limit, 0 for none
+    DiameterBounds bounds;          // Result
+    
+    if ( !load_graph( G, vertexCount ) ) return;
+    
+    do
+    {
+        printf(" Use edge weights as lengths? (1 yes, 0 no)\n");
+        printf(" > ");
+        cin >> weighted;
+    } while ( !(weighted == 0 || weighted == 1) );
+    
+    do
+    {
+        printf(" Stop after how many searches? (0 to run until exact)\n");
+        printf(" > ");
+        cin >> budget;
+    } while ( !(budget >= 0) );
+    cout << endl;
+    
+    if ( weighted )
+    {
+        for ( unsigned int i = 0; i < G.size(); i++ )
+        {
+            if ( G[i].getW() < 0 )
+            {
+                cout << "Edge weights must be positive to measure lengths." 
+                     << endl << endl;
+                return;
+            }
+        }
+    }
+    
+    /** Largest component, entered at its highest degree vertex **/
+    DisjointSet components( vertexCount );
+    vector< int > size( vertexCount, 0 );   // Vertices per component root
+    int root = 0;                           // Where the searches begin
+    int largest;                            // Root of the largest component
+    
+    for ( unsigned int i = 0; i < G.size(); i++ )
+        components.join( G[i].getU(), G[i].getV() );
+    for ( unsigned int v = 0; v < vertexCount; v++ )
+        size[ components.find( v ) ]++;
+    largest = max_element( size.begin(), size.end() ) - size.begin();
+    
+    csr_adjacency( G, vertexCount, start, neighbor, weight );
+    for ( unsigned int v = 0; v < vertexCount; v++ )
+    {
+        int degree = start[v+1] - start[v];
+        
+        if ( components.find( v ) == largest && 
+             ( components.find( root ) != largest || 
+               degree > start[root+1] - start[root] ) )
+            root = v;
+    }
+    
+    if ( size[largest] < (int)vertexCount )
+        cout << "G is disconnected (infinite diameter); measuring its "
+             << "largest component of " << size[largest] << " vertices." 
+             << endl << endl;
+    
+    if ( weighted )
+        bounding_diameters( start, neighbor, weight, root, budget, bounds );
+    else
+        ifub_diameter( start, neighbor, root, budget, bounds );
+    
+    if ( bounds.lower == bounds.upper )
+        cout << "Diameter: " << bounds.lower << endl;
+    else
+        cout << "Diameter: between " << bounds.lower << " and " 
+             << bounds.upper << " (search budget reached)" << endl;
+    cout << "   vertices " << bounds.from << " and " << bounds.to 
+         << " are " << bounds.lower << " apart" << endl
+         << "Searches made: " << bounds.searches << " of " << size[largest] 
+         << " for all pairs" << endl << endl;
+}
+
+/*=============================================================================
+Function: csr_adjacency
+Description: Packs the adjacency of G into flat arrays: the neighbours of
+             vertex x are neighbor[start[x]] .. neighbor[start[x+1]-1], with
+             the matching edge weights in weight. Loops are left out.
+Parameters: G - weighted edges stored as UVW vector set
+            vertexCount - verticy cardinality for G
+            start - receives the offsets, vertexCount + 1 of them
+            neighbor - receives the adjacent vertices
+            weight - receives the edge weights
+=============================================================================*/
+void csr_adjacency( const vector< WeightedEdge > &G, unsigned int vertexCount,
+                    vector< int > &start, vector< int > &neighbor,
+                    vector< int > &weight )
+{
+    vector< int > fill;                 // Next free slot per vertex
+    
+    start.assign( vertexCount + 1, 0 );
+    for ( unsigned int i = 0; i < G.size(); i++ )
+    {
+        if ( G[i].getU() == G[i].getV() ) continue;
+        start[ G[i].getU() + 1 ]++;
+        start[ G[i].getV() + 1 ]++;
+    }
+    for ( unsigned int v = 0; v < vertexCount; v++ ) start[v+1] += start[v];
+    
+    fill.assign( start.begin(), start.end() - 1 );
+    neighbor.resize( start[vertexCount] );
+    weight.resize( start[vertexCount] );
+    for ( unsigned int i = 0; i < G.size(); i++ )
+    {
+        int u = G[i].getU();
+        int v = G[i].getV();
+        
+        if ( u == v ) continue;
+        neighbor[ fill[u] ] = v;
+        weight[ fill[u]++ ] = G[i].getW();
+        neighbor[ fill[v] ] = u;
+        weight[ fill[v]++ ] = G[i].getW();
+    }
+}
+
+/*=============================================================================
+Function: bfs_eccentricity
+Description: Breadth first search by levels; wide levels are expanded in
+             parallel. Returns the eccentricity of the source within its
+             component.
+Parameters: start, neighbor - adjacency from csr_adjacency
+            source - where the search begins
+            dist - receives the hop count to each vertex, -1 if unreached
+            farthest - receives the lowest numbered vertex on the last level
+=============================================================================*/
+int bfs_eccentricity( const vector< int > &start, 
+                      const vector< int > &neighbor, int source, 
+                      vector< int > &dist, int &farthest )
+{
+    vector< int > frontier( 1, source );    // Vertices at the current level
+    int eccentricity = 0;
+    
+    dist.assign( start.size() - 1, -1 );
+    dist[source] = 0;
+    farthest = source;
+    
+    for ( int d = 1; !frontier.empty(); d++ )
+    {
+        vector< int > found;                // Candidates one level further
+        
+        #pragma omp parallel if ( frontier.size() >= 4096 )
+        {
+            vector< int > local;            // This thread's candidates
+            
+            #pragma omp for nowait
+            for ( int i = 0; i < (int)frontier.size(); i++ )
+            {
+                int x = frontier[i];
+                
+                for ( int e = start[x]; e < start[x+1]; e++ )
+                    if ( dist[ neighbor[e] ] < 0 ) 
+                        local.push_back( neighbor[e] );
+            }
+            
+            #pragma omp critical (bfs_found)
+            found.insert( found.end(), local.begin(), local.end() );
+        }
+        
+        frontier.clear();
+        for ( unsigned int i = 0; i < found.size(); i++ )
+        {
+            if ( dist[ found[i] ] >= 0 ) continue;
+            dist[ found[i] ] = d;
+            frontier.push_back( found[i] );
+        }
+        
+        if ( !frontier.empty() )
+        {
+            eccentricity = d;
+            farthest = *min_element( frontier.begin(), frontier.end() );
+        }
+    }
+    
+    return eccentricity;
+}
+
+/*=============================================================================
+Function: dijkstra_eccentricity
+Description: Dijkstra's shortest paths. Returns the eccentricity of the
+             source within its component.
+Parameters: start, neighbor, weight - adjacency from csr_adjacency
+            source - where the search begins
+            dist - receives the distance to each vertex, -1 if unreached
+            farthest - receives a vertex at the largest distance
+=============================================================================*/
+long long dijkstra_eccentricity( const vector< int > &start, 
+                                 const vector< int > &neighbor,
+                                 const vector< int > &weight, int source,
+                                 vector< long long > &dist, int &farthest )
+{
+    priority_queue< pair< long long, int >, vector< pair< long long, int > >,
+                    greater< pair< long long, int > > > heap;
+    long long eccentricity = 0;
+    
+    dist.assign( start.size() - 1, -1 );
+    dist[source] = 0;
+    farthest = source;
+    heap.push( make_pair( 0LL, source ) );
+    
+    while ( !heap.empty() )
+    {
+        long long d = heap.top().first;
+        int x = heap.top().second;
+        heap.pop();
+        
+        if ( d > dist[x] ) continue;
+        if ( d > eccentricity )
+        {
+            eccentricity = d;
+            farthest = x;
+        }
+        
+        for ( int e = start[x]; e < start[x+1]; e++ )
+        {
+            int y = neighbor[e];
+            
+            if ( dist[y] < 0 || d + weight[e] < dist[y] )
+            {
+                dist[y] = d + weight[e];
+                heap.push( make_pair( dist[y], y ) );
+            }
+        }
+    }
+    
+    return eccentricity;
+}
+
+/*=============================================================================
+Function: ifub_diameter
+Description: iFUB (iterative fringe upper bound) for unweighted graphs. A
+             2-sweep (search from root, then from the farthest vertex)
+             gives a lower bound. A central vertex u is then sought among
+             the vertices whose largest distance to the searched ones is
+             smallest, with a few more sweeps while its eccentricity keeps
+             dropping. Any two vertices within i levels of u are at most 2i
+             apart, so after searching from every vertex of the outer levels
+             of u down to level i the diameter is at most max(lower, 2i-2).
+             A search from s also gives ecc(x) <= ecc(s) + d(s,x), so fringe
+             vertices already known to be no farther out than the lower
+             bound are skipped. Fringe searches run in parallel batches that
+             start small and double, so early bounds can prune later ones;
+             each thread folds its bounds locally and merges them per batch.
+Parameters: start, neighbor - adjacency from csr_adjacency
+            root - a vertex of the component to measure
+            budget - search limit, 0 for none
+            bounds - receives the result
+=============================================================================*/
+void ifub_diameter( const vector< int > &start, const vector< int > &neighbor,
+                    int root, long long budget, DiameterBounds &bounds )
+{
+    const int CHUNK = 256;              // Most fringe searches per batch
+    const int CENTER_ROUNDS = 4;        // Sweeps spent looking for a center
+    int n = start.size() - 1;
+    vector< int > dist;                 // Hops from the latest sweep
+    vector< int > distU;                // Hops from the central vertex u
+    vector< int > reach( n, -1 );       // Largest hop count to a sweep
+    vector< int > high( n, n );         // Upper bound on each eccentricity
+    int eccU = n;                       // Eccentricity of u
+    int far;                            // Farthest vertex of a sweep
+    
+    bounds.lower = 0;
+    bounds.from = bounds.to = root;
+    bounds.searches = 0;
+    
+    /** 2-sweep **/
+    far = diameter_sweep( start, neighbor, root, dist, reach, high, bounds );
+    far = diameter_sweep( start, neighbor, far, dist, reach, high, bounds );
+    
+    /** Central vertex **/
+    for ( int round = 0; round < CENTER_ROUNDS; round++ )
+    {
+        int c = -1;                     // Candidate center
+        
+        for ( int v = 0; v < n; v++ )
+            if ( reach[v] >= 0 && ( c < 0 || reach[v] < reach[c] ) ) c = v;
+        
+        far = diameter_sweep( start, neighbor, c, dist, reach, high, bounds );
+        if ( dist[far] >= eccU ) break;
+        
+        eccU = dist[far];
+        distU = dist;
+        diameter_sweep( start, neighbor, far, dist, reach, high, bounds );
+    }
+    bounds.upper = max( bounds.lower, 2LL * eccU );
+    
+    /** Fringe levels of u, outermost first **/
+    vector< vector< int > > level( eccU + 1 );
+    int chunk = 1;                      // Searches in the next batch
+    
+    for ( int v = 0; v < n; v++ )
+        if ( distU[v] >= 0 ) level[ distU[v] ].push_back( v );
+    
+    for ( int i = eccU; i > 0 && bounds.lower < bounds.upper; i-- )
+    {
+        const vector< int > &F = level[i];
+        unsigned int next = 0;          // Next vertex of F to consider
+        
+        while ( next < F.size() && bounds.lower < bounds.upper )
+        {
+            vector< int > batch;        // Vertices to search from
+            bool exhausted = false;     // Budget runs out with this batch
+            
+            while ( next < F.size() && batch.size() < (unsigned int)chunk )
+            {
+                if ( high[ F[next] ] > bounds.lower ) 
+                    batch.push_back( F[next] );
+                next++;
+            }
+            if ( budget > 0 && 
+                 bounds.searches + (long long)batch.size() >= budget )
+            {
+                batch.resize( max( 0LL, budget - bounds.searches ) );
+                exhausted = true;
+            }
+            
+            int count = batch.size();
+            vector< int > ecc( count );
+            vector< int > ends( count );
+            
+            #pragma omp parallel if ( count > 1 )
+            {
+                vector< int > local;    // This thread's eccentricity bounds
+                vector< int > d;        // Hops from the current search
+                
+                #pragma omp for schedule(dynamic) nowait
+                for ( int k = 0; k < count; k++ )
+                {
+                    ecc[k] = bfs_eccentricity( start, neighbor, batch[k], 
+                                               d, ends[k] );
+                    if ( local.empty() ) local.assign( n, n );
+                    for ( int v = 0; v < n; v++ )
+                        if ( d[v] >= 0 ) 
+                            local[v] = min( local[v], ecc[k] + d[v] );
+                }
+                
+                if ( !local.empty() )
+                {
+                    #pragma omp critical (ifub_high)
+                    for ( int v = 0; v < n; v++ ) 
+                        high[v] = min( high[v], local[v] );
+                }
+            }
+            
+            for ( int k = 0; k < count; k++ )
+            {
+                if ( ecc[k] <= bounds.lower ) continue;
+                bounds.lower = ecc[k];
+                bounds.from = batch[k];
+                bounds.to = ends[k];
+            }
+            bounds.searches += count;
+            bounds.upper = max( bounds.lower, 2LL * i );
+            chunk = min( CHUNK, 2 * chunk );
+            
+            if ( exhausted ) return;
+        }
+        
+        bounds.upper = max( bounds.lower, 2LL * ( i - 1 ) );
+    }
+}
+
+/*=============================================================================
+Function: diameter_sweep
+Description: One search of the iFUB start: records the eccentricity of the
+             source as a diameter candidate and raises each vertex's
+             largest hop count to a searched vertex (a lower bound on its
+             eccentricity) and lowers its upper bound. Returns the farthest
+             vertex from the source.
+Parameters: start, neighbor - adjacency from csr_adjacency
+            source - where the search begins
+            dist - receives the hop count to each vertex, -1 if unreached
+            reach - largest hop count to a searched vertex, -1 if unreached
+            high - upper bound on each eccentricity
+            bounds - diameter bounds to update
+=============================================================================*/
+int diameter_sweep( const vector< int > &start, const vector< int > &neighbor,
+                    int source, vector< int > &dist, vector< int > &reach,
+                    vector< int > &high, DiameterBounds &bounds )
+{
+    int farthest;
+    int ecc = bfs_eccentricity( start, neighbor, source, dist, farthest );
+    
+    bounds.searches++;
+    if ( ecc > bounds.lower || bounds.searches == 1 )
+    {
+        bounds.lower = ecc;
+        bounds.from = source;
+        bounds.to = farthest;
+    }
+    
+    #pragma omp parallel for if ( dist.size() >= 4096 )
+    for ( int v = 0; v < (int)dist.size(); v++ )
+    {
+        reach[v] = max( reach[v], dist[v] );
+        if ( dist[v] >= 0 ) high[v] = min( high[v], ecc + dist[v] );
+    }
+    
+    return farthest;
+}
+
+/*=============================================================================
+Function: bounding_diameters
+Description: Takes-Kosters eccentricity bounding for weighted graphs. A
+             search from v gives ecc(v) and, for every w,
+                 max(d(v,w), ecc(v) - d(v,w)) <= ecc(w) <= ecc(v) + d(v,w)
+             Sources alternate between the largest upper bound and the
+             smallest lower bound among vertices that could still beat the
+             best diameter found. The bound updates run in parallel.
+Parameters: start, neighbor, weight - adjacency from csr_adjacency
+            root - a vertex of the component to measure
+            budget - search limit, 0 for none
+            bounds - receives the result
+=============================================================================*/
+void bounding_diameters( const vector< int > &start, 
+                         const vector< int > &neighbor,
+                         const vector< int > &weight, int root, 
+                         long long budget, DiameterBounds &bounds )
+{
+    const long long UNBOUNDED = numeric_limits< long long >::max();
+    int n = start.size() - 1;
+    vector< long long > dist;               // Distances from the source
+    vector< long long > low( n, 0 );        // Lower bound on each ecc
+    vector< long long > high( n, UNBOUNDED );
+                                            // Upper bound on each ecc
+    vector< char > inside( n, 0 );          // Marks the measured component
+    bool pickHigh = true;                   // Which end to pick next
+    int source = root;
+    
+    bounds.lower = 0;
+    bounds.upper = UNBOUNDED;
+    bounds.from = bounds.to = root;
+    bounds.searches = 0;
+    
+    while ( bounds.lower < bounds.upper )
+    {
+        if ( budget > 0 && bounds.searches >= budget ) return;
+        
+        int farthest;
+        long long ecc = dijkstra_eccentricity( start, neighbor, weight, 
+                                               source, dist, farthest );
+        long long upper = 0;
+        
+        bounds.searches++;
+        if ( bounds.searches == 1 )
+            for ( int w = 0; w < n; w++ ) inside[w] = dist[w] >= 0;
+        if ( ecc > bounds.lower )
+        {
+            bounds.lower = ecc;
+            bounds.from = source;
+            bounds.to = farthest;
+        }
+        
+        /** Tighten every vertex's bounds **/
+        // Lower bounds never pass the largest eccentricity found, so only
+        // the upper bounds move the diameter bounds
+        #pragma omp parallel for reduction(max:upper)
+        for ( int w = 0; w < n; w++ )
+        {
+            if ( !inside[w] ) continue;
+            
+            low[w] = max( low[w], max( dist[w], ecc - dist[w] ) );
+            high[w] = min( high[w], ecc + dist[w] );
+            upper = max( upper, high[w] );
+        }
+        bounds.upper = upper;
+        
+        /** Next source **/
+        source = -1;
+        for ( int w = 0; w < n; w++ )
+        {
+            // Settled, or cannot exceed the diameter found
+            if ( !inside[w] || low[w] == high[w] || 
+                 high[w] <= bounds.lower ) continue;
+            
+            if ( source < 0 || 
+                 ( pickHigh ? high[w] > high[source] 
+                            : low[w] < low[source] ) )
+                source = w;
+        }
+        pickHigh = !pickHigh;
+        if ( source < 0 ) break;
+    }
+    
+    bounds.upper = bounds.lower;
+}
+
+/*=============================================================================
+Function: betweenness_centrality
+Description: Computes the betweenness of every vertex of input.txt: the
+             sum over vertex pairs s, t of the share of shortest s-t paths
+             passing through it. Exact mode runs Brandes' algorithm from
+             every source; sampled mode from k random sources, scaled by
+             n/k. Each sampled term lies in [0, n(n-2)/2], so by Hoeffding
+             and a union bound over the vertices every estimate is within
+                 n(n-2)/2 * sqrt( ln(2n/delta) / 2k )
+             of the exact value with probability 1 - delta. Source i is
+             drawn from its own random stream seeded by (seed, i).
+             
+             All values go to betweenness.txt as
+                 vertex  betweenness
+=============================================================================*/
+void betweenness_centrality()
+{
+    const unsigned int SHOWN = 10;  // Vertices listed on screen
+    unsigned int vertexCount = 0;   // Stores vertex count from input file
+    vector< WeightedEdge > G;       // Our graph
+    vector< int > start;            // Adjacency offsets per vertex
+    vector< int > neighbor;         // Adjacent vertices
+    vector< int > weight;           // Weights of the adjacencies
+    int weighted;                   // Whether paths are measured by weight
+    int mode;                       // 1 exact, 2 sampled
+    int sampleCount = 0;            // Sources drawn in sampled mode
+    double delta = 0;               // Chance the sampled bound may miss
+    unsigned int seed = 0;          // Base seed of the random streams
+    vector< int > sources;          // Where the searches begin
+    vector< double > centrality;    // Result per vertex
+    ofstream outfile;               // Stores output file data
+    
+    if ( !load_graph( G, vertexCount ) ) return;
+    
+    do
+    {
+        printf(" Use edge weights as lengths? (1 yes, 0 no)\n");
+        printf(" > ");
+        cin >> weighted;
+    } while ( !(weighted == 0 || weighted == 1) );
+    
+    do
+    {
+        printf(" 1: Exact (every source)\n");
+        printf(" 2: Sampled sources\n");
+        printf(" > ");
+        cin >> mode;
+    } while ( !(mode == 1 || mode == 2) );
+    
+    if ( mode == 2 )
+    {
+        do
+        {
+            printf(" How many sources?\n");
+            printf(" > ");
+            cin >> sampleCount;
+        } while ( !(sampleCount > 0) );
+        
+        do
+        {
+            printf(" Chance the error bound may miss (e.g. 0.05)?\n");
+            printf(" > ");
+            cin >> delta;
+        } while ( !(delta > 0 && delta < 1) );
+        
+        printf(" Random seed?\n");
+        printf(" > ");
+        cin >> seed;
+    }
+    cout << endl;
+    
+    if ( weighted )
+    {
+        for ( unsigned int i = 0; i < G.size(); i++ )
+        {
+            if ( G[i].getW() < 0 )
+            {
+                cout << "Edge weights must be positive to measure lengths." 
+                     << endl << endl;
+                return;
+            }
+        }
+    }
+    
+    /** Sources **/
+    if ( mode == 1 )
+    {
+        for ( unsigned int v = 0; v < vertexCount; v++ ) sources.push_back( v );
+    }
+    else
+    {
+        sources.resize( sampleCount );
+        for ( int i = 0; i < sampleCount; i++ )
+        {
+            seed_seq stream{ seed, (unsigned int)i };
+            mt19937_64 rng( stream );
+            uniform_int_distribution< int > pick( 0, vertexCount - 1 );
+            
+            sources[i] = pick( rng );
+        }
+    }
+    
+    csr_adjacency( G, vertexCount, start, neighbor, weight );
+    brandes_betweenness( start, neighbor, weight, weighted, sources, 
+                         centrality );
+    
+    // Each pair was counted from both ends
+    double scale = 0.5 * vertexCount / sources.size();
+    for ( unsigned int v = 0; v < vertexCount; v++ ) centrality[v] *= scale;
+    
+    /** Report **/
+    vector< int > ranked( vertexCount );
+    
+    for ( unsigned int v = 0; v < vertexCount; v++ ) ranked[v] = v;
+    stable_sort( ranked.begin(), ranked.end(), [&]( int a, int b ) 
+                 { return centrality[a] > centrality[b]; } );
+    
+    cout << "Most central vertices:" << endl;
+    for ( unsigned int i = 0; i < min( SHOWN, vertexCount ); i++ )
+        cout << "   " << ranked[i] << ": " << centrality[ ranked[i] ] << endl;
+    cout << endl;
+    
+    if ( mode == 2 )
+    {
+        double n = vertexCount;
+        double bound = n * ( n - 2 ) / 2 
+                     * sqrt( log( 2 * n / delta ) / ( 2.0 * sampleCount ) );
+        
+        cout << "Every estimate is within " << max( bound, 0.0 ) 
+             << " of the exact value with probability " << 1 - delta 
+             << endl << endl;
+    }
+    
+    outfile.open( "betweenness.txt" );
+    outfile.precision( 12 );
+    for ( unsigned int v = 0; v < vertexCount; v++ )
+        outfile << v << " " << centrality[v] << endl;
+    outfile.close();
+    
+    cout << "All values written to betweenness.txt" << endl << endl;
+}
+
+/*=============================================================================
+Function: brandes_betweenness
+Description: Brandes' algorithm. From each source s a search (BFS, or
+             Dijkstra when weighted) counts the shortest paths sigma to
+             every vertex; then, in reverse order of distance, each vertex
+             w passes sigma(v)/sigma(w) * (1 + delta(w)) back to every
+             predecessor v, and delta(w) is what s contributes to w.
+             Predecessors are found again from the distances rather than
+             stored. Sources are shared out between threads, each adding
+             into its own accumulator; the accumulators are summed at the
+             end. Pairs are counted from both ends and nothing is scaled.
+Parameters: start, neighbor, weight - adjacency from csr_adjacency
+            weighted - whether paths are measured by weight or by hops
+            sources - sources to search from (repeats allowed)
+            centrality - receives the summed dependencies of each vertex
+=============================================================================*/
+void brandes_betweenness( const vector< int > &start, 
+                          const vector< int > &neighbor,
+                          const vector< int > &weight, bool weighted,
+                          const vector< int > &sources, 
+                          vector< double > &centrality )
+{
+    int n = start.size() - 1;
+    
+    centrality.assign( n, 0 );
+    
+    #pragma omp parallel
+    {
+        vector< double > local( n, 0 );     // This thread's accumulator
+        vector< long long > dist( n, -1 );  // Distance from the source
+        vector< double > sigma( n, 0 );     // Shortest paths from the source
+        vector< double > delta( n, 0 );     // Dependency of the source
+        vector< int > order;                // Vertices by distance
+        priority_queue< pair< long long, int >, 
+                        vector< pair< long long, int > >,
+                        greater< pair< long long, int > > > heap;
+        
+        #pragma omp for schedule(dynamic, 16) nowait
+        for ( int i = 0; i < (int)sources.size(); i++ )
+        {
+            int s = sources[i];
+            
+            dist[s] = 0;
+            sigma[s] = 1;
+            order.clear();
+            
+            /** Count shortest paths **/
+            if ( !weighted )
+            {
+                order.push_back( s );
+                for ( unsigned int head = 0; head < order.size(); head++ )
+                {
+                    int x = order[head];
+                    
+                    for ( int e = start[x]; e < start[x+1]; e++ )
+                    {
+                        int y = neighbor[e];
+                        
+                        if ( dist[y] < 0 )
+                        {
+                            dist[y] = dist[x] + 1;
+                            order.push_back( y );
+                        }
+                        if ( dist[y] == dist[x] + 1 ) sigma[y] += sigma[x];
+                    }
+                }
+            }
+            else
+            {
+                heap.push( make_pair( 0LL, s ) );
+                while ( !heap.empty() )
+                {
+                    long long d = heap.top().first;
+                    int x = heap.top().second;
+                    heap.pop();
+                    
+                    if ( d > dist[x] ) continue;
+                    order.push_back( x );
+                    
+                    for ( int e = start[x]; e < start[x+1]; e++ )
+                    {
+                        int y = neighbor[e];
+                        long long through = d + weight[e];
+                        
+                        if ( dist[y] < 0 || through < dist[y] )
+                        {
+                            dist[y] = through;
+                            sigma[y] = sigma[x];
+                            heap.push( make_pair( through, y ) );
+                        }
+                        else if ( through == dist[y] ) sigma[y] += sigma[x];
+                    }
+                }
+            }
+            
+            /** Pass dependencies back towards the source **/
+            for ( int k = order.size() - 1; k > 0; k-- )
+            {
+                int w = order[k];
+                double share = ( 1 + delta[w] ) / sigma[w];
+                long long step = 1;
+                
+                for ( int e = start[w]; e < start[w+1]; e++ )
+                {
+                    int v = neighbor[e];
+                    
+                    if ( weighted ) step = weight[e];
+                    if ( dist[v] >= 0 && dist[v] + step == dist[w] )
+                        delta[v] += sigma[v] * share;
+                }
+                local[w] += delta[w];
+            }
+            
+            for ( unsigned int k = 0; k < order.size(); k++ )
+            {
+                dist[ order[k] ] = -1;
+                sigma[ order[k] ] = 0;
+                delta[ order[k] ] = 0;
+            }
+        }
+        
+        #pragma omp critical (brandes_sum)
+        for ( int v = 0; v < n; v++ ) centrality[v] += local[v];
+    }
+}
+
+/*=============================================================================
+Function: spectral_invariants
+Description: Eigenvalues of the adjacency matrix A and the Laplacian
+             L = D - A: full spectra of input.txt (dense, up to 500
+             vertices), the Fiedler value (second smallest eigenvalue of L,
+             the algebraic connectivity) of input.txt by Lanczos, or both
+             spectra of every graph in generated_graphs.txt.
+             
+             The batch solves each isomorphism class once. Classes of the
+             same size are packed into lanes and diagonalized together by
+             the vectorized Jacobi solver, lane groups in parallel.
+             Per-graph results go to spectra.txt as
+                 graph  vertices  class  algebraic connectivity
+                 A: adjacency eigenvalues
+                 L: Laplacian eigenvalues
+             and the classes sharing a spectrum (cospectral but not
+             isomorphic) are counted.
+=============================================================================*/
+void spectral_invariants()
+{
+    const unsigned int DENSE_LIMIT = 500;   // Largest input.txt for spectra
+    const int LANES = 8;                    // Graphs per Jacobi batch
+    int source;                     // 1 spectra, 2 Fiedler, 3 the batch
+    
+    do
+    {
+        printf(" 1: Spectra of input.txt\n");
+        printf(" 2: Fiedler value of input.txt (Lanczos)\n");
+        printf(" 3: Spectra of generated_graphs.txt\n");
+        printf(" > ");
+        cin >> source;
+    } while ( !(source >= 1 && source <= 3) );
+    cout << endl;
+    
+    if ( source == 1 )
+    {
+        unsigned int vertexCount = 0;   // Stores vertex count from input file
+        vector< WeightedEdge > G;       // Our graph
+        vector< vector< int > > M;      // G as a symmetric matrix
+        vector< double > adjacency;     // Eigenvalues of A
+        vector< double > laplacian;     // Eigenvalues of L
+        
+        if ( !load_graph( G, vertexCount ) ) return;
+        
+        if ( vertexCount > DENSE_LIMIT )
+        {
+            cout << "Dense spectra are limited to " << DENSE_LIMIT 
+                 << " vertices; use the Lanczos option for larger graphs." 
+                 << endl << endl;
+            return;
+        }
+        
+        graph_to_matrix( G, vertexCount, M );
+        graph_spectra( M, adjacency, laplacian );
+        
+        cout << "Adjacency eigenvalues:" << endl << "  ";
+        for ( unsigned int k = 0; k < vertexCount; k++ )
+            cout << " " << ( fabs( adjacency[k] ) < 1e-9 ? 0 : adjacency[k] );
+        cout << endl << endl << "Laplacian eigenvalues:" << endl << "  ";
+        for ( unsigned int k = 0; k < vertexCount; k++ )
+            cout << " " << ( fabs( laplacian[k] ) < 1e-9 ? 0 : laplacian[k] );
+        cout << endl << endl << "Algebraic connectivity: " 
+             << ( fabs( laplacian[1] ) < 1e-9 ? 0 : laplacian[1] ) 
+             << endl << endl;
+        return;
+    }
+    
+    if ( source == 2 )
+    {
+        unsigned int vertexCount = 0;   // Stores vertex count from input file
+        vector< WeightedEdge > G;       // Our graph
+        vector< int > start;            // Adjacency offsets per vertex
+        vector< int > neighbor;         // Adjacent vertices
+        vector< int > weight;           // Weights of the adjacencies
+        vector< double > fiedler;       // Eigenvector of the Fiedler value
+        int restarts;                   // Lanczos cycles run
+        double residual;                // Final residual norm
+        ofstream outfile;               // Stores the Fiedler vector
+        
+        if ( !load_graph( G, vertexCount ) ) return;
+        
+        DisjointSet components( vertexCount );
+        unsigned int joined = 0;        // Unions made
+        
+        for ( unsigned int i = 0; i < G.size(); i++ )
+        {
+            if ( G[i].getW() < 0 )
+            {
+                cout << "Edge weights must be positive for the Laplacian." 
+                     << endl << endl;
+                return;
+            }
+            if ( components.join( G[i].getU(), G[i].getV() ) ) joined++;
+        }
+        
+        if ( joined + 1 < vertexCount )
+        {
+            cout << "G is disconnected, so its algebraic connectivity is 0." 
+                 << endl << endl;
+            return;
+        }
+        
+        csr_adjacency( G, vertexCount, start, neighbor, weight );
+        double lambda;                  // Fiedler value
+        bool converged = lanczos_fiedler( start, neighbor, weight, lambda,
+                                          fiedler, restarts, residual );
+        
+        cout << "Algebraic connectivity (Fiedler value): " << lambda << endl
+             << "   residual " << residual << " after " << restarts 
+             << " Lanczos cycles" << ( converged ? "" : " (not converged)" ) 
+             << endl;
+        
+        outfile.open( "fiedler_vector.txt" );
+        outfile.precision( 12 );
+        for ( unsigned int v = 0; v < vertexCount; v++ )
+            outfile << v << " " << fiedler[v] << endl;
+        outfile.close();
+        
+        cout << "Fiedler vector written to fiedler_vector.txt" 
+             << endl << endl;
+        return;
+    }
+    
+    /** Group the batch into isomorphism classes **/
+    ifstream inputFile;                     // Stores generated graph data
+    ofstream outfile;                       // Stores per-graph results
+    vector< vector< int > > M;              // Current graph
+    map< GraphHash, int > classOf;          // Class index of each hash
+    vector< vector< vector< int > > > rep;  // First graph of each class
+    vector< int > graphClass;               // Class of each graph
+    
+    if ( !check_file( inputFile, "generated_graphs.txt" ) ) return;
+    
+    while ( read_generated_graph( inputFile, M ) )
+    {
+        vector< int > label;
+        GraphHash h = canonical_hash( M, label );
+        
+        if ( classOf.find( h ) == classOf.end() )
+        {
+            classOf[h] = rep.size();
+            rep.push_back( M );
+        }
+        graphClass.push_back( classOf[h] );
+    }
+    inputFile.close();
+    
+    /** Pack classes of one size into lane groups **/
+    map< int, vector< int > > bySize;       // Vertex count -> classes
+    vector< vector< int > > groups;         // Classes solved together
+    
+    for ( unsigned int c = 0; c < rep.size(); c++ )
+        bySize[ rep[c].size() ].push_back( c );
+    for ( map< int, vector< int > >::iterator it = bySize.begin(); 
+          it != bySize.end(); ++it )
+    {
+        for ( unsigned int i = 0; i < it->second.size(); i += LANES )
+            groups.push_back( vector< int >( it->second.begin() + i, 
+                it->second.begin() + min( (size_t)i + LANES, 
+                                          it->second.size() ) ) );
+    }
+    
+    /** Solve each group **/
+    vector< vector< double > > adjacency( rep.size() );
+    vector< vector< double > > laplacian( rep.size() );
+    
+    #pragma omp parallel for schedule(dynamic)
+    for ( int g = 0; g < (int)groups.size(); g++ )
+    {
+        const vector< int > &members = groups[g];
+        int n = rep[ members[0] ].size();
+        int lanes = members.size();
+        vector< double > A( (size_t)n * n * lanes, 0 );
+        vector< double > L( (size_t)n * n * lanes, 0 );
+        vector< double > eigenvalues;
+        
+        // Entry (i, j) of lane b sits at ( i*n + j ) * lanes + b
+        for ( int b = 0; b < lanes; b++ )
+        {
+            const vector< vector< int > > &R = rep[ members[b] ];
+            
+            for ( int i = 0; i < n; i++ )
+            {
+                for ( int j = 0; j < n; j++ )
+                {
+                    if ( i == j || R[i][j] == 0 ) continue;
+                    A[ ( (size_t)i * n + j ) * lanes + b ] = R[i][j];
+                    L[ ( (size_t)i * n + j ) * lanes + b ] = -R[i][j];
+                    L[ ( (size_t)i * n + i ) * lanes + b ] += R[i][j];
+                }
+            }
+        }
+        
+        batch_jacobi( n, lanes, A, eigenvalues, NULL );
+        for ( int b = 0; b < lanes; b++ )
+        {
+            vector< double > &spectrum = adjacency[ members[b] ];
+            
+            for ( int k = 0; k < n; k++ ) 
+                spectrum.push_back( eigenvalues[ k * lanes + b ] );
+            sort( spectrum.begin(), spectrum.end() );
+        }
+        
+        batch_jacobi( n, lanes, L, eigenvalues, NULL );
+        for ( int b = 0; b < lanes; b++ )
+        {
+            vector< double > &spectrum = laplacian[ members[b] ];
+            
+            for ( int k = 0; k < n; k++ ) 
+                spectrum.push_back( eigenvalues[ k * lanes + b ] );
+            sort( spectrum.begin(), spectrum.end() );
+        }
+    }
+    
+    /** Spectra shared between classes **/
+    // Key: vertex count, then eigenvalues rounded to 1e-6
+    map< vector< long long >, int > adjacencyShared;
+    map< vector< long long >, int > laplacianShared;
+    vector< vector< long long > > adjacencyKey( rep.size() );
+    vector< vector< long long > > laplacianKey( rep.size() );
+    
+    for ( unsigned int c = 0; c < rep.size(); c++ )
+    {
+        adjacencyKey[c].push_back( rep[c].size() );
+        laplacianKey[c].push_back( rep[c].size() );
+        for ( unsigned int k = 0; k < rep[c].size(); k++ )
+        {
+            adjacencyKey[c].push_back( llround( adjacency[c][k] * 1e6 ) );
+            laplacianKey[c].push_back( llround( laplacian[c][k] * 1e6 ) );
+        }
+        adjacencyShared[ adjacencyKey[c] ]++;
+        laplacianShared[ laplacianKey[c] ]++;
+    }
+    
+    /** Fan results out **/
+    map< int, vector< int > > tally;    // Vertices -> graphs, classes,
+                                        // A-cospectral classes,
+                                        // L-cospectral classes, connected
+    
+    outfile.open( "spectra.txt" );
+    for ( unsigned int i = 0; i < graphClass.size(); i++ )
+    {
+        int c = graphClass[i];
+        int n = rep[c].size();
+        double connectivity = n > 1 ? laplacian[c][1] : 0;
+        
+        if ( fabs( connectivity ) < 1e-9 ) connectivity = 0;
+        outfile << i + 1 << " " << n << " " << c << " " << connectivity 
+                << endl << "A:";
+        for ( int k = 0; k < n; k++ ) 
+            outfile << " " << ( fabs( adjacency[c][k] ) < 1e-9 
+                                ? 0 : adjacency[c][k] );
+        outfile << endl << "L:";
+        for ( int k = 0; k < n; k++ ) 
+            outfile << " " << ( fabs( laplacian[c][k] ) < 1e-9 
+                                ? 0 : laplacian[c][k] );
+        outfile << endl;
+        
+        vector< int > &t = tally[n];
+        t.resize( 5, 0 );
+        t[0]++;
+        t[4] += connectivity > 0;
+    }
+    outfile.close();
+    
+    for ( unsigned int c = 0; c < rep.size(); c++ )
+    {
+        vector< int > &t = tally[ rep[c].size() ];
+        t[1]++;
+        t[2] += adjacencyShared[ adjacencyKey[c] ] > 1;
+        t[3] += laplacianShared[ laplacianKey[c] ] > 1;
+    }
+    
+    cout << "Spectra of generated_graphs.txt:" << endl;
+    for ( map< int, vector< int > >::iterator it = tally.begin(); 
+          it != tally.end(); ++it )
+    {
+        cout << "   " << it->first << " vertices: " << it->second[0] 
+             << " graphs, " << it->second[1] << " classes, " 
+             << it->second[4] << " graphs connected" << endl
+             << "      classes sharing their adjacency spectrum: " 
+             << it->second[2] << ", Laplacian spectrum: " << it->second[3] 
+             << endl;
+    }
+    cout << endl << "Solved " << rep.size() << " classes for " 
+         << graphClass.size() << " graphs" << endl
+         << "Per-graph results written to spectra.txt" << endl << endl;
+}
+
+/*=============================================================================
+Function: batch_jacobi
+Description: Cyclic Jacobi eigenvalue method on a batch of symmetric
+             matrices of the same order. Each rotation zeroes entry (p, q)
+             of every matrix with its own angle; the matrices are
+             interleaved, entry (i, j) of matrix b at (i*n + j)*lanes + b,
+             so the rotation loops run across the batch and vectorize.
+             Sweeps continue until every matrix's off-diagonal mass is
+             negligible.
+Parameters: n - order of the matrices
+            lanes - matrices in the batch
+            a - the interleaved matrices, diagonalized in place
+            eigenvalues - receives eigenvalue k of matrix b at k*lanes + b
+                          (in diagonal order, not sorted)
+            vectors - if not NULL, receives the eigenvectors interleaved
+                      the same way, eigenvector k in column k
+=============================================================================*/
+void batch_jacobi( int n, int lanes, vector< double > &a, 
+                   vector< double > &eigenvalues, vector< double > *vectors )
+{
+    const int MAX_SWEEPS = 50;          // Jacobi converges in far fewer
+    const double TOLERANCE = 1e-24;     // Off-diagonal share of the mass
+    vector< double > c( lanes );        // Rotation cosine per matrix
+    vector< double > s( lanes );        // Rotation sine per matrix
+    
+    if ( vectors != NULL )
+    {
+        vectors->assign( (size_t)n * n * lanes, 0 );
+        for ( int k = 0; k < n; k++ )
+            for ( int b = 0; b < lanes; b++ )
+                (*vectors)[ ( (size_t)k * n + k ) * lanes + b ] = 1;
+    }
+    
+    for ( int sweep = 0; sweep < MAX_SWEEPS; sweep++ )
+    {
+        bool converged = true;
+        
+        for ( int b = 0; b < lanes && converged; b++ )
+        {
+            double off = 0;             // Squared off-diagonal entries
+            double total = 0;           // Squared entries
+            
+            for ( int i = 0; i < n; i++ )
+            {
+                for ( int j = 0; j < n; j++ )
+                {
+                    double x = a[ ( (size_t)i * n + j ) * lanes + b ];
+                    total += x * x;
+                    if ( i != j ) off += x * x;
+                }
+            }
+            if ( off > TOLERANCE * total ) converged = false;
+        }
+        if ( converged ) break;
+        
+        for ( int p = 0; p < n; p++ )
+        {
+            for ( int q = p + 1; q < n; q++ )
+            {
+                double *pp = &a[ ( (size_t)p * n + p ) * lanes ];
+                double *qq = &a[ ( (size_t)q * n + q ) * lanes ];
+                double *pq = &a[ ( (size_t)p * n + q ) * lanes ];
+                
+                /** Angles that zero (p, q) **/
+                #pragma omp simd
+                for ( int b = 0; b < lanes; b++ )
+                {
+                    double theta = ( qq[b] - pp[b] ) / ( 2 * pq[b] );
+                    double t = ( theta >= 0 ? 1.0 : -1.0 ) 
+                             / ( fabs( theta ) + sqrt( theta * theta + 1 ) );
+                    
+                    c[b] = pq[b] == 0 ? 1 : 1 / sqrt( t * t + 1 );
+                    s[b] = pq[b] == 0 ? 0 : t * c[b];
+                }
+                
+                /** A = A P, then A = P^T A **/
+                for ( int k = 0; k < n; k++ )
+                {
+                    double *kp = &a[ ( (size_t)k * n + p ) * lanes ];
+                    double *kq = &a[ ( (size_t)k * n + q ) * lanes ];
+                    
+                    #pragma omp simd
+                    for ( int b = 0; b < lanes; b++ )
+                    {
+                        double x = kp[b];
+                        double y = kq[b];
+                        kp[b] = c[b] * x - s[b] * y;
+                        kq[b] = s[b] * x + c[b] * y;
+                    }
+                }
+                for ( int k = 0; k < n; k++ )
+                {
+                    double *pk = &a[ ( (size_t)p * n + k ) * lanes ];
+                    double *qk = &a[ ( (size_t)q * n + k ) * lanes ];
+                    
+                    #pragma omp simd
+                    for ( int b = 0; b < lanes; b++ )
+                    {
+                        double x = pk[b];
+                        double y = qk[b];
+                        pk[b] = c[b] * x - s[b] * y;
+                        qk[b] = s[b] * x + c[b] * y;
+                    }
+                }
+                
+                if ( vectors == NULL ) continue;
+                for ( int k = 0; k < n; k++ )
+                {
+                    double *kp = &(*vectors)[ ( (size_t)k * n + p ) * lanes ];
+                    double *kq = &(*vectors)[ ( (size_t)k * n + q ) * lanes ];
+                    
+                    #pragma omp simd
+                    for ( int b = 0; b < lanes; b++ )
+                    {
+                        double x = kp[b];
+                        double y = kq[b];
+                        kp[b] = c[b] * x - s[b] * y;
+                        kq[b] = s[b] * x + c[b] * y;
+                    }
+                }
+            }
+        }
+    }
+    
+    eigenvalues.resize( (size_t)n * lanes );
+    for ( int k = 0; k < n; k++ )
+        for ( int b = 0; b < lanes; b++ )
+            eigenvalues[ (size_t)k * lanes + b ] = 
+                a[ ( (size_t)k * n + k ) * lanes + b ];
+}
+
+/*=============================================================================
+Function: graph_spectra
+Description: Sorted eigenvalues of the adjacency matrix and the Laplacian
+             of one weighted graph
+Parameters: M - symmetric weight matrix, 0 where there is no edge
+            adjacency - receives the eigenvalues of A
+            laplacian - receives the eigenvalues of L = D - A
+=============================================================================*/
+void graph_spectra( const vector< vector< int > > &M, 
+                    vector< double > &adjacency, vector< double > &laplacian )
+{
+    int n = M.size();
+    vector< double > A( (size_t)n * n, 0 );
+    vector< double > L( (size_t)n * n, 0 );
+    
+    for ( int i = 0; i < n; i++ )
+    {
+        for ( int j = 0; j < n; j++ )
+        {
+            if ( i == j || M[i][j] == 0 ) continue;
+            A[ (size_t)i * n + j ] = M[i][j];
+            L[ (size_t)i * n + j ] = -M[i][j];
+            L[ (size_t)i * n + i ] += M[i][j];
+        }
+    }
+    
+    batch_jacobi( n, 1, A, adjacency, NULL );
+    batch_jacobi( n, 1, L, laplacian, NULL );
+    sort( adjacency.begin(), adjacency.end() );
+    sort( laplacian.begin(), laplacian.end() );
+}
+
+/*=============================================================================
+Function: laplacian_multiply
+Description: y = L x for the weighted Laplacian, (L x)(v) = sum over edges
+             vu of w(vu) * ( x(v) - x(u) ); rows in parallel
+Parameters: start, neighbor, weight - adjacency from csr_adjacency
+            x - input vector
+            y - receives L x
+=============================================================================*/
+void laplacian_multiply( const vector< int > &start, 
+                         const vector< int > &neighbor,
+                         const vector< int > &weight, 
+                         const vector< double > &x, vector< double > &y )
+{
+    int n = start.size() - 1;
+    
+    y.resize( n );
+    
+    #pragma omp parallel for if ( n >= 4096 )
+    for ( int v = 0; v < n; v++ )
+    {
+        double sum = 0;
+        
+        for ( int e = start[v]; e < start[v+1]; e++ )
+            sum += weight[e] * ( x[v] - x[ neighbor[e] ] );
+        y[v] = sum;
+    }
+}
+
+/*=============================================================================
+Function: lanczos_fiedler
+Description: Second smallest Laplacian eigenvalue of a connected graph by
+             thick-restart Lanczos. The constant vector spans the eigenvalue
+             0, so the Krylov space is kept orthogonal to it and its
+             smallest Ritz value converges to the Fiedler value. Each cycle
+             runs up to 80 steps with full reorthogonalization, recording
+             the projection H = V^T L V, and diagonalizes H with Jacobi.
+             The next cycle keeps the 30 smallest Ritz vectors and the
+             residual direction, so the nearby eigenvalues that slow a
+             single-vector restart stay deflated. Cycles stop once the
+             residual is below 1e-10 of the Gershgorin bound on the
+             spectrum. Vector operations on large graphs run in parallel.
+             Returns false if the cycle limit ran out first.
+Parameters: start, neighbor, weight - adjacency from csr_adjacency
+            lambda - receives the smallest Ritz value
+            fiedler - receives the unit eigenvector
+            restarts - receives the number of cycles run
+            residual - receives |L y - lambda y| for the returned vector
+=============================================================================*/
+bool lanczos_fiedler( const vector< int > &start, 
+                      const vector< int > &neighbor,
+                      const vector< int > &weight, double &lambda,
+                      vector< double > &fiedler, int &restarts, 
+                      double &residual )
+{
+    const int STEPS = 80;               // Krylov steps per cycle
+    const int KEEP = 30;                // Ritz vectors kept on restart
+    const int MAX_CYCLES = 500;         // Cycles before giving up
+    const double TOLERANCE = 1e-10;     // Relative residual to stop at
+    int n = start.size() - 1;
+    int m = min( STEPS, n - 1 );        // Steps fit in the space besides 1
+    int keep = min( KEEP, m - 2 );      // Room for at least one new step
+    int kept = 0;                       // Ritz vectors opening this cycle
+    double bound = 0;                   // Gershgorin bound on the spectrum
+    double last = 0;                    // Norm of the last residual
+    vector< double > basis( (size_t)m * n );
+                                        // Lanczos vectors, one per row
+    vector< double > w;                 // Work vector
+    vector< double > H;                 // Projection of L on the basis
+    vector< double > theta;             // Ritz values
+    vector< double > Z;                 // Ritz vectors in the basis
+    mt19937_64 rng( n );                // Start vector
+    uniform_real_distribution< double > pick( -1, 1 );
+    
+    for ( int v = 0; v < n; v++ )
+    {
+        double degree = 0;
+        
+        for ( int e = start[v]; e < start[v+1]; e++ ) degree += weight[e];
+        bound = max( bound, 2 * degree );
+    }
+    
+    lambda = 0;
+    residual = 0;
+    fiedler.resize( n );
+    for ( int v = 0; v < n; v++ ) fiedler[v] = pick( rng );
+    
+    for ( restarts = 1; restarts <= MAX_CYCLES; restarts++ )
+    {
+        int steps = m;                  // Steps taken this cycle
+        
+        if ( kept == 0 )
+        {
+            /** Start vector: orthogonal to 1, unit length **/
+            double mean = 0;
+            double norm = 0;
+            
+            #pragma omp parallel for reduction(+:mean) if ( n >= 4096 )
+            for ( int v = 0; v < n; v++ ) mean += fiedler[v];
+            mean /= n;
+            
+            #pragma omp parallel for reduction(+:norm) if ( n >= 4096 )
+            for ( int v = 0; v < n; v++ ) 
+            {
+                fiedler[v] -= mean;
+                norm += fiedler[v] * fiedler[v];
+            }
+            norm = sqrt( norm );
+            for ( int v = 0; v < n; v++ ) basis[v] = fiedler[v] / norm;
+        }
+        
+        // Kept Ritz vectors are already diagonal in H
+        H.assign( (size_t)m * m, 0 );
+        for ( int i = 0; i < kept; i++ ) H[ (size_t)i * m + i ] = theta[i];
+        
+        /** Lanczos steps **/
+        for ( int j = kept; j < m; j++ )
+        {
+            const double *V = &basis[ (size_t)j * n ];
+            vector< double > row( V, V + n );
+            
+            laplacian_multiply( start, neighbor, weight, row, w );
+            
+            // Full reorthogonalization against 1 and every Lanczos vector,
+            // twice over since one Gram-Schmidt pass can leave some behind.
+            // The coefficients add up to column j of H.
+            for ( int pass = 0; pass < 2; pass++ )
+            {
+                for ( int i = 0; i <= j; i++ )
+                {
+                    const double *U = &basis[ (size_t)i * n ];
+                    double h = 0;
+                    
+                    #pragma omp parallel for reduction(+:h) if ( n >= 4096 )
+                    for ( int v = 0; v < n; v++ ) h += w[v] * U[v];
+                    
+                    #pragma omp parallel for if ( n >= 4096 )
+                    for ( int v = 0; v < n; v++ ) w[v] -= h * U[v];
+                    H[ (size_t)i * m + j ] += h;
+                }
+            }
+            for ( int i = 0; i < j; i++ ) 
+                H[ (size_t)j * m + i ] = H[ (size_t)i * m + j ];
+            
+            double shift = 0;
+            double length = 0;
+            
+            #pragma omp parallel for reduction(+:shift) if ( n >= 4096 )
+            for ( int v = 0; v < n; v++ ) shift += w[v];
+            shift /= n;
+            
+            #pragma omp parallel for reduction(+:length) if ( n >= 4096 )
+            for ( int v = 0; v < n; v++ ) 
+            {
+                w[v] -= shift;
+                length += w[v] * w[v];
+            }
+            last = sqrt( length );
+            
+            // An invariant subspace ends the cycle early
+            if ( last <= 1e-12 * bound ) 
+            {
+                steps = j + 1;
+                break;
+            }
+            if ( j + 1 < m )
+            {
+                double *next = &basis[ (size_t)( j + 1 ) * n ];
+                for ( int v = 0; v < n; v++ ) next[v] = w[v] / last;
+            }
+        }
+        
+        /** Ritz pairs, smallest first **/
+        vector< double > T( (size_t)steps * steps );
+        vector< double > values;
+        vector< double > vectors;
+        vector< int > order( steps );
+        
+        for ( int i = 0; i < steps; i++ )
+        {
+            for ( int j = 0; j < steps; j++ )
+                T[ (size_t)i * steps + j ] = H[ (size_t)i * m + j ];
+            order[i] = i;
+        }
+        batch_jacobi( steps, 1, T, values, &vectors );
+        sort( order.begin(), order.end(), 
+              [&]( int a, int b ) { return values[a] < values[b]; } );
+        
+        theta.resize( steps );
+        Z.resize( (size_t)steps * steps );
+        for ( int k = 0; k < steps; k++ )
+        {
+            theta[k] = values[ order[k] ];
+            for ( int j = 0; j < steps; j++ )
+                Z[ (size_t)j * steps + k ] = 
+                    vectors[ (size_t)j * steps + order[k] ];
+        }
+        
+        lambda = theta[0];
+        residual = fabs( last * Z[ (size_t)( steps - 1 ) * steps ] );
+        
+        /** Ritz vectors, the Fiedler estimate first **/
+        int count = max( keep, 1 );     // Ritz vectors to form
+        vector< double > ritz( (size_t)count * n );
+        
+        #pragma omp parallel for if ( n >= 4096 )
+        for ( int v = 0; v < n; v++ )
+        {
+            for ( int k = 0; k < count; k++ )
+            {
+                double sum = 0;
+                
+                for ( int j = 0; j < steps; j++ )
+                    sum += Z[ (size_t)j * steps + k ] 
+                           * basis[ (size_t)j * n + v ];
+                ritz[ (size_t)k * n + v ] = sum;
+            }
+        }
+        for ( int v = 0; v < n; v++ ) fiedler[v] = ritz[v];
+        
+        if ( residual <= TOLERANCE * bound ) break;
+        if ( steps < m || keep < 1 )
+        {
+            // Nothing to thicken with: restart from the Fiedler estimate
+            kept = 0;
+            continue;
+        }
+        
+        /** Thick restart: kept Ritz vectors, then the residual direction **/
+        kept = keep;
+        copy( ritz.begin(), ritz.end(), basis.begin() );
+        for ( int v = 0; v < n; v++ ) 
+            basis[ (size_t)kept * n + v ] = w[v] / last;
+    }
+    restarts = min( restarts, MAX_CYCLES );
+    
+    return residual <= TOLERANCE * bound;
+}